@@ -0,0 +1,600 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include "chunk_test_fixture.h"
+#include "chunk_test_heap.h"
+#include "chunk_render_internal.h"  // chunk_gather_tile_ids for the gather microbenchmark
+#include "tilemap/tilemap.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Headless benchmark suite for ChunkRenderSystem
+// Runs against RecordingRenderer, so commands and texture traffic are counted
+// exactly and timings cover CPU-side work only. All scenarios are seeded and
+// deterministic.
+
+#define WORLD_SIZE 2048          // Dense tile ids, wrapped in both directions
+#define TILE_ID_COUNT 256
+#define TILE_SIZE 16
+#define CHUNK_SIZE 64
+#define RENDER_RADIUS 5
+#define SIMULATION_RADIUS 10
+#define VIEWPORT_WIDTH 1280.0f
+#define VIEWPORT_HEIGHT 720.0f
+#define GATHER_CHUNKS 64         // Distinct chunks gathered per microbenchmark run
+#define GATHER_RUNS 20
+#define EVICT_BYTES (64u << 20)  // Written between runs to push the world out of cache
+
+// Tilemap_get_tile is served from BenchTilemap through ld --wrap, so the
+// per-tile fallback of chunk_gather_tile_ids runs against a real call
+#ifndef CHUNK_BENCH_WRAP_TILEMAP
+#define CHUNK_BENCH_WRAP_TILEMAP 0
+#endif
+
+typedef ChunkTestWorld BenchWorld;
+typedef ChunkTestContext BenchContext;
+
+typedef struct BenchResult {
+    int frames;
+    uint64_t updateTotal;
+    uint64_t updateMax;
+    uint64_t renderTotal;
+    uint64_t renderMax;
+    size_t commands;
+    size_t textureCreations;
+    size_t arenaAllocations;
+    size_t heapAllocations;
+    size_t peakTextureBytes;
+} BenchResult;
+
+// Allocation counters at the start of a measured window
+typedef struct BenchAllocs {
+    size_t arena;
+    size_t heap;
+} BenchAllocs;
+
+static uint64_t now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+// Tile structs of the bench world, read one at a time with bounds checks
+// (passed to the system as its Tilemap*)
+typedef struct BenchTilemap {
+    Tile* tiles;
+    int size;
+} BenchTilemap;
+
+#if CHUNK_BENCH_WRAP_TILEMAP
+Tile* __wrap_Tilemap_get_tile(Tilemap* tilemap, int tileX, int tileY) {
+    BenchTilemap* map = (BenchTilemap*)tilemap;
+    int x = tileX % map->size;
+    int y = tileY % map->size;
+    if (x < 0) x += map->size;
+    if (y < 0) y += map->size;
+    return &map->tiles[(size_t)y * (size_t)map->size + (size_t)x];
+}
+#endif
+
+static bool tilemap_init(BenchTilemap* map, const BenchWorld* world) {
+    size_t tiles = (size_t)world->size * (size_t)world->size;
+    map->size = world->size;
+    map->tiles = (Tile*)calloc(tiles, sizeof(Tile));
+    if (!map->tiles) return false;
+    for (size_t i = 0; i < tiles; i++) {
+        map->tiles[i].tile_id = (uint32_t)world->tileIds[i];
+    }
+    return true;
+}
+
+// Read tiles through Tilemap_get_tile instead of the bulk row hook
+static void use_tilemap(BenchContext* ctx, BenchTilemap* map) {
+    ctx->system.tilemap = (Tilemap*)map;
+    ChunkRenderSystem_set_tile_row_fetch(&ctx->system, NULL, NULL);
+}
+
+static const ChunkTestConfig BENCH_CONFIG = {
+    TILE_SIZE, CHUNK_SIZE, RENDER_RADIUS, SIMULATION_RADIUS,
+    VIEWPORT_WIDTH, VIEWPORT_HEIGHT, TILE_ID_COUNT, 16, true
+};
+
+static void context_init(BenchContext* ctx, BenchWorld* world, bool batched) {
+    ChunkTestConfig config = BENCH_CONFIG;
+    config.batched = batched;
+    chunk_test_context_init(ctx, &config, world);
+}
+
+static void run_frame(BenchContext* ctx, BenchResult* result) {
+    size_t commandsBefore = ctx->recorder.commands;
+    
+    uint64_t start = now_us();
+    ChunkRenderSystem_update(&ctx->system, NULL, 0, NULL);
+    uint64_t mid = now_us();
+    ChunkRenderSystem_render(&ctx->system, NULL, 0, (CameraHandle)&ctx->camera, (AspectFitHandle)&ctx->aspectFit);
+    uint64_t end = now_us();
+    
+    uint64_t updateTime = mid - start;
+    uint64_t renderTime = end - mid;
+    result->frames++;
+    result->updateTotal += updateTime;
+    result->renderTotal += renderTime;
+    if (updateTime > result->updateMax) result->updateMax = updateTime;
+    if (renderTime > result->renderMax) result->renderMax = renderTime;
+    result->commands += ctx->recorder.commands - commandsBefore;
+}
+
+// Counters now; without a context the window starts before the system exists
+static BenchAllocs alloc_counts(const BenchContext* ctx) {
+    BenchAllocs allocs = {ctx ? ctx->system.arenaAllocations : 0, chunk_test_heap_allocations()};
+    return allocs;
+}
+
+static void finish(BenchContext* ctx, BenchResult* result, BenchAllocs start) {
+    result->textureCreations = ctx->recorder.textureCreations;
+    result->peakTextureBytes = ctx->recorder.peakTextureBytes;
+    result->arenaAllocations = ctx->system.arenaAllocations - start.arena;
+    result->heapAllocations = chunk_test_heap_allocations() - start.heap;
+}
+
+static void report(const char* name, const BenchResult* r) {
+    int frames = r->frames > 0 ? r->frames : 1;
+    printf("%-22s %6d %10.1f %10llu %10.1f %10llu %12.1f %10zu %10.1f %8zu ",
+           name, r->frames,
+           (double)r->updateTotal / frames, (unsigned long long)r->updateMax,
+           (double)r->renderTotal / frames, (unsigned long long)r->renderMax,
+           (double)r->commands / frames,
+           r->textureCreations,
+           (double)r->peakTextureBytes / (1024.0 * 1024.0),
+           r->arenaAllocations);
+    if (chunk_test_heap_counted()) {
+        printf("%8zu\n", r->heapAllocations);
+    } else {
+        printf("%8s\n", "-");
+    }
+}
+
+// First frames around a fresh spawn with nothing resident
+static void scenario_cold_spawn(BenchWorld* world) {
+    BenchContext ctx;
+    BenchResult result = {0};
+    BenchAllocs start = alloc_counts(NULL);
+    context_init(&ctx, world, true);
+    
+    ChunkRenderSystem_add_manual_observer(&ctx.system, 512, 512);
+    chunk_test_look_at(&ctx, 512, 512);
+    for (int frame = 0; frame < 30; frame++) {
+        run_frame(&ctx, &result);
+    }
+    
+    finish(&ctx, &result, start);
+    report("cold-spawn", &result);
+    chunk_test_context_cleanup(&ctx);
+}
+
+// One observer walking east; steady state should create no textures
+// With prefetch the ring ahead is prepared on the worker thread
+static void scenario_steady_walk(BenchWorld* world, const char* name, bool prefetch) {
+    BenchContext ctx;
+    BenchResult result = {0};
+    context_init(&ctx, world, true);
+    if (prefetch && !ChunkRenderSystem_enable_prefetch(&ctx.system, 16)) {
+        chunk_test_context_cleanup(&ctx);
+        return;
+    }
+    ChunkRenderSystem_set_residency_budget(&ctx.system, 160, 0);
+    ChunkRenderSystem_configure_render_target_pool(&ctx.system, 64, 0);
+    ChunkRenderSystem_set_rebuild_budget(&ctx.system, 4, 0);
+    
+    int x = 512, y = 512;
+    ChunkRenderSystem_add_manual_observer(&ctx.system, x, y);
+    for (int frame = 0; frame < 60; frame++) {
+        chunk_test_look_at(&ctx, x, y);
+        ChunkRenderSystem_update(&ctx.system, NULL, 0, NULL);
+    }
+    
+    BenchAllocs start = alloc_counts(&ctx);
+    for (int frame = 0; frame < 1200; frame++) {
+        ChunkRenderSystem_move_manual_observer(&ctx.system, x, y, x + 2, y);
+        x += 2;
+        chunk_test_look_at(&ctx, x, y);
+        run_frame(&ctx, &result);
+    }
+    
+    finish(&ctx, &result, start);
+    report(name, &result);
+    chunk_test_context_cleanup(&ctx);
+}
+
+// Observer jumps 20 chunks every 60 frames
+// With a time budget the arrival is spread over frames; without one the
+// whole ring is rebuilt in one update, which the worker threads split up
+static void scenario_teleport(BenchWorld* world, const char* name, int threads, uint32_t budgetMicros) {
+    BenchContext ctx;
+    BenchResult result = {0};
+    BenchAllocs start = alloc_counts(NULL);
+    context_init(&ctx, world, true);
+    ChunkRenderSystem_set_residency_budget(&ctx.system, 256, 0);
+    ChunkRenderSystem_set_rebuild_budget(&ctx.system, 0, budgetMicros);
+    if (threads > 1 && !ChunkRenderSystem_set_worker_threads(&ctx.system, threads)) {
+        chunk_test_context_cleanup(&ctx);
+        return;
+    }
+    
+    int x = 512, y = 512;
+    ChunkRenderSystem_add_manual_observer(&ctx.system, x, y);
+    for (int frame = 0; frame < 600; frame++) {
+        if (frame > 0 && frame % 60 == 0) {
+            ChunkRenderSystem_remove_manual_observer(&ctx.system, x, y);
+            x += 20 * CHUNK_SIZE;
+            y -= 7 * CHUNK_SIZE;
+            ChunkRenderSystem_add_manual_observer(&ctx.system, x, y);
+        }
+        chunk_test_look_at(&ctx, x, y);
+        run_frame(&ctx, &result);
+    }
+    
+    finish(&ctx, &result, start);
+    report(name, &result);
+    chunk_test_context_cleanup(&ctx);
+}
+
+// 64 observers milling around one town
+static void scenario_clustered_observers(BenchWorld* world) {
+    enum { OBSERVERS = 64 };
+    BenchContext ctx;
+    BenchResult result = {0};
+    BenchAllocs start = alloc_counts(NULL);
+    context_init(&ctx, world, true);
+    
+    int xs[OBSERVERS], ys[OBSERVERS];
+    for (int i = 0; i < OBSERVERS; i++) {
+        xs[i] = 512 + (int)(chunk_test_random(&ctx.rng) % 256) - 128;
+        ys[i] = 512 + (int)(chunk_test_random(&ctx.rng) % 256) - 128;
+        ChunkRenderSystem_add_manual_observer(&ctx.system, xs[i], ys[i]);
+    }
+    chunk_test_look_at(&ctx, 512, 512);
+    
+    for (int frame = 0; frame < 600; frame++) {
+        for (int i = 0; i < OBSERVERS; i++) {
+            if (chunk_test_random(&ctx.rng) % 4 != 0) continue;
+            ChunkRenderSystem_remove_manual_observer(&ctx.system, xs[i], ys[i]);
+            xs[i] += (int)(chunk_test_random(&ctx.rng) % 3) - 1;
+            ys[i] += (int)(chunk_test_random(&ctx.rng) % 3) - 1;
+            ChunkRenderSystem_add_manual_observer(&ctx.system, xs[i], ys[i]);
+        }
+        run_frame(&ctx, &result);
+    }
+    
+    finish(&ctx, &result, start);
+    report("clustered-observers", &result);
+    chunk_test_context_cleanup(&ctx);
+}
+
+// Thousands of NPC observers wandering a region, moved through their handles
+// Most steps stay inside the same chunk, so coverage is rarely rebuilt
+static void scenario_npc_observers(BenchWorld* world) {
+    enum { OBSERVERS = 4096 };
+    BenchContext ctx;
+    BenchResult result = {0};
+    BenchAllocs start = alloc_counts(NULL);
+    context_init(&ctx, world, true);
+    ChunkRenderSystem_set_rebuild_budget(&ctx.system, 8, 0);
+    
+    static int xs[OBSERVERS], ys[OBSERVERS];
+    static ChunkObserverHandle handles[OBSERVERS];
+    for (int i = 0; i < OBSERVERS; i++) {
+        xs[i] = 256 + (int)(chunk_test_random(&ctx.rng) % 512);
+        ys[i] = 256 + (int)(chunk_test_random(&ctx.rng) % 512);
+        handles[i] = ChunkRenderSystem_add_manual_observer(&ctx.system, xs[i], ys[i]);
+    }
+    chunk_test_look_at(&ctx, 512, 512);
+    
+    for (int frame = 0; frame < 600; frame++) {
+        for (int i = 0; i < OBSERVERS; i++) {
+            if (chunk_test_random(&ctx.rng) % 2 != 0) continue;
+            xs[i] += (int)(chunk_test_random(&ctx.rng) % 3) - 1;
+            ys[i] += (int)(chunk_test_random(&ctx.rng) % 3) - 1;
+            ChunkRenderSystem_move_observer(&ctx.system, handles[i], xs[i], ys[i]);
+        }
+        run_frame(&ctx, &result);
+    }
+    
+    finish(&ctx, &result, start);
+    report("npc-observers", &result);
+    chunk_test_context_cleanup(&ctx);
+}
+
+// Steady walk over an ocean map; with dedup the ocean chunks share one texture
+static void scenario_ocean_walk(BenchWorld* world, const char* name, bool dedup) {
+    BenchContext ctx;
+    BenchResult result = {0};
+    BenchAllocs start = alloc_counts(NULL);
+    context_init(&ctx, world, true);
+    ChunkRenderSystem_set_chunk_dedup(&ctx.system, dedup);
+    ChunkRenderSystem_set_residency_budget(&ctx.system, 160, 0);
+    ChunkRenderSystem_configure_render_target_pool(&ctx.system, 8, 0);
+    
+    int x = 512, y = 512;
+    ChunkRenderSystem_add_manual_observer(&ctx.system, x, y);
+    for (int frame = 0; frame < 1200; frame++) {
+        ChunkRenderSystem_move_manual_observer(&ctx.system, x, y, x + 2, y);
+        x += 2;
+        chunk_test_look_at(&ctx, x, y);
+        run_frame(&ctx, &result);
+    }
+    
+    finish(&ctx, &result, start);
+    report(name, &result);
+    chunk_test_context_cleanup(&ctx);
+}
+
+// Two players walking apart on split screen plus a zoomed-out minimap
+// Extra views render from the same chunks; their time and commands are
+// added to the frame's render numbers
+static void scenario_split_screen(BenchWorld* world) {
+    BenchContext ctx;
+    BenchResult result = {0};
+    BenchAllocs start = alloc_counts(NULL);
+    context_init(&ctx, world, true);
+    ChunkRenderSystem_set_lod(&ctx.system, 2, 0.1f);
+    
+    ctx.camera.offset.x = VIEWPORT_WIDTH * 0.25f;
+    RecordingCamera secondCamera = ctx.camera;
+    RecordingCamera minimapCamera = ctx.camera;
+    minimapCamera.zoom = 0.125f;
+    int second = ChunkRenderSystem_add_viewport(&ctx.system, VIEWPORT_WIDTH * 0.5f, VIEWPORT_HEIGHT);
+    int minimap = ChunkRenderSystem_add_viewport(&ctx.system, 0, 0);
+    ChunkRenderSystem_set_viewport_size(&ctx.system, VIEWPORT_WIDTH * 0.5f, VIEWPORT_HEIGHT);
+    
+    int x = 512, y = 512;
+    ChunkObserverHandle first = ChunkRenderSystem_add_manual_observer(&ctx.system, x, y);
+    ChunkObserverHandle other = ChunkRenderSystem_add_manual_observer(&ctx.system, x, y);
+    for (int frame = 0; frame < 600; frame++) {
+        ChunkRenderSystem_move_observer(&ctx.system, first, x - frame, y);
+        ChunkRenderSystem_move_observer(&ctx.system, other, x + frame, y);
+        chunk_test_look_at(&ctx, x - frame, y);
+        secondCamera.target.x = (float)((x + frame) * TILE_SIZE);
+        minimapCamera.target = ctx.camera.target;
+        run_frame(&ctx, &result);
+        
+        size_t commandsBefore = ctx.recorder.commands;
+        uint64_t start = now_us();
+        ChunkRenderSystem_render_viewport(&ctx.system, second, NULL, 0,
+                                          (CameraHandle)&secondCamera, (AspectFitHandle)&ctx.aspectFit);
+        ChunkRenderSystem_render_viewport(&ctx.system, minimap, NULL, 0,
+                                          (CameraHandle)&minimapCamera, (AspectFitHandle)&ctx.aspectFit);
+        uint64_t renderTime = now_us() - start;
+        result.renderTotal += renderTime;
+        if (renderTime > result.renderMax) result.renderMax = renderTime;
+        result.commands += ctx.recorder.commands - commandsBefore;
+    }
+    
+    finish(&ctx, &result, start);
+    report("split-screen-minimap", &result);
+    chunk_test_context_cleanup(&ctx);
+}
+
+// Zoomed-out view of the whole render radius, drawn per chunk or per page
+static void scenario_zoomed_out(BenchWorld* world, const char* name, int pageChunks) {
+    BenchContext ctx;
+    BenchResult result = {0};
+    context_init(&ctx, world, true);
+    ChunkRenderSystem_enable_page_packing(&ctx.system, pageChunks);
+    
+    ChunkRenderSystem_add_manual_observer(&ctx.system, 512, 512);
+    chunk_test_look_at(&ctx, 512, 512);
+    ctx.camera.zoom = 0.1f;
+    for (int frame = 0; frame < 10; frame++) {
+        ChunkRenderSystem_update(&ctx.system, NULL, 0, NULL);
+    }
+    
+    BenchAllocs start = alloc_counts(&ctx);
+    for (int frame = 0; frame < 300; frame++) {
+        run_frame(&ctx, &result);
+    }
+    
+    finish(&ctx, &result, start);
+    report(name, &result);
+    chunk_test_context_cleanup(&ctx);
+}
+
+// Mining/building: 200 scattered tile edits per frame around the observer
+static void scenario_tile_churn(BenchWorld* world) {
+    BenchContext ctx;
+    BenchResult result = {0};
+    BenchAllocs start = alloc_counts(NULL);
+    context_init(&ctx, world, true);
+    
+    ChunkRenderSystem_add_manual_observer(&ctx.system, 512, 512);
+    chunk_test_look_at(&ctx, 512, 512);
+    ChunkRenderSystem_update(&ctx.system, NULL, 0, NULL);
+    
+    for (int frame = 0; frame < 600; frame++) {
+        for (int i = 0; i < 200; i++) {
+            int tileX = 512 + (int)(chunk_test_random(&ctx.rng) % 512) - 256;
+            int tileY = 512 + (int)(chunk_test_random(&ctx.rng) % 512) - 256;
+            *chunk_test_world_tile(world, tileX, tileY) = (int)(chunk_test_random(&ctx.rng) % TILE_ID_COUNT);
+            ChunkRenderSystem_mark_tile_dirty(&ctx.system, tileX, tileY);
+        }
+        run_frame(&ctx, &result);
+    }
+    
+    finish(&ctx, &result, start);
+    report("tile-churn", &result);
+    chunk_test_context_cleanup(&ctx);
+}
+
+// Full rebuild of every chunk in the radius, repeated; isolates rebuild cost
+// A tilemap replaces the row hook with per-tile Tilemap_get_tile reads
+static void scenario_rebuild(BenchWorld* world, const char* name, bool batched, BenchTilemap* tilemap) {
+    BenchContext ctx;
+    BenchResult result = {0};
+    BenchAllocs start = alloc_counts(NULL);
+    context_init(&ctx, world, batched);
+    if (tilemap) {
+        use_tilemap(&ctx, tilemap);
+    }
+    
+    int x = 512;
+    ChunkRenderSystem_add_manual_observer(&ctx.system, x, 512);
+    chunk_test_look_at(&ctx, x, 512);
+    for (int frame = 0; frame < 20; frame++) {
+        // Move a full radius each frame so every chunk is cold
+        ChunkRenderSystem_remove_manual_observer(&ctx.system, x, 512);
+        x += (2 * RENDER_RADIUS + 1) * CHUNK_SIZE;
+        ChunkRenderSystem_add_manual_observer(&ctx.system, x, 512);
+        chunk_test_look_at(&ctx, x, 512);
+        run_frame(&ctx, &result);
+    }
+    
+    finish(&ctx, &result, start);
+    report(name, &result);
+    chunk_test_context_cleanup(&ctx);
+}
+
+// Cached vs direct rendering at one zoom level, with optional tile edits
+// Edits land inside the view so both paths see them
+static void scenario_crossover(BenchWorld* world, float zoom, ChunkRenderMode mode, int editsPerFrame) {
+    BenchContext ctx;
+    BenchResult result = {0};
+    context_init(&ctx, world, true);
+    ChunkRenderSystem_set_render_mode(&ctx.system, mode);
+    
+    ChunkRenderSystem_add_manual_observer(&ctx.system, 512, 512);
+    chunk_test_look_at(&ctx, 512, 512);
+    ctx.camera.zoom = zoom;
+    run_frame(&ctx, &result);
+    memset(&result, 0, sizeof(result));
+    
+    int halfWidth = (int)(VIEWPORT_WIDTH / (2.0f * TILE_SIZE * zoom));
+    int halfHeight = (int)(VIEWPORT_HEIGHT / (2.0f * TILE_SIZE * zoom));
+    BenchAllocs start = alloc_counts(&ctx);
+    for (int frame = 0; frame < 200; frame++) {
+        for (int i = 0; i < editsPerFrame; i++) {
+            int tileX = 512 + (int)(chunk_test_random(&ctx.rng) % (uint32_t)(2 * halfWidth + 1)) - halfWidth;
+            int tileY = 512 + (int)(chunk_test_random(&ctx.rng) % (uint32_t)(2 * halfHeight + 1)) - halfHeight;
+            *chunk_test_world_tile(world, tileX, tileY) = (int)(chunk_test_random(&ctx.rng) % TILE_ID_COUNT);
+            ChunkRenderSystem_mark_tile_dirty(&ctx.system, tileX, tileY);
+        }
+        run_frame(&ctx, &result);
+    }
+    
+    char name[32];
+    snprintf(name, sizeof(name), "x%.2g-%s%s", zoom,
+             mode == CHUNK_RENDER_MODE_DIRECT ? "direct" : (mode == CHUNK_RENDER_MODE_AUTO ? "auto" : "cached"),
+             editsPerFrame > 0 ? "-edits" : "");
+    finish(&ctx, &result, start);
+    report(name, &result);
+    chunk_test_context_cleanup(&ctx);
+}
+
+static void evict_caches(unsigned char* buffer) {
+    for (size_t i = 0; i < EVICT_BYTES; i += 64) {
+        buffer[i]++;
+    }
+}
+
+// Microseconds to gather GATHER_CHUNKS chunks, minimum over cold runs
+static double time_gather(BenchContext* ctx, unsigned char* evictBuffer) {
+    ChunkTileRegion region = {0, 0, CHUNK_SIZE, CHUNK_SIZE};
+    int chunksPerRow = WORLD_SIZE / CHUNK_SIZE;
+    uint64_t best = UINT64_MAX;
+    
+    for (int run = 0; run < GATHER_RUNS; run++) {
+        evict_caches(evictBuffer);
+        uint64_t start = now_us();
+        for (int i = 0; i < GATHER_CHUNKS; i++) {
+            // Spread over the world so no two chunks share cache lines
+            int chunk = (i * 37 + run * 11) % (chunksPerRow * chunksPerRow);
+            chunk_gather_tile_ids(&ctx->system, chunk % chunksPerRow, chunk / chunksPerRow, &region, ctx->system.tileIds);
+        }
+        uint64_t elapsed = now_us() - start;
+        if (elapsed < best) best = elapsed;
+    }
+    return (double)best;
+}
+
+// Cold-cache tile gather alone: the bulk row hook against the per-tile
+// Tilemap_get_tile fallback in chunk_gather_tile_ids
+static void scenario_gather(BenchWorld* world, BenchTilemap* tilemap) {
+    unsigned char* evictBuffer = (unsigned char*)calloc(EVICT_BYTES, 1);
+    if (!evictBuffer) return;
+    
+    BenchContext ctx;
+    context_init(&ctx, world, true);
+    double rowHook = time_gather(&ctx, evictBuffer);
+    if (!tilemap) {
+        printf("gather cold: row hook %.2f us/chunk; per-tile fallback not measured (no ld --wrap)\n",
+               rowHook / GATHER_CHUNKS);
+    } else {
+        use_tilemap(&ctx, tilemap);
+        double perTile = time_gather(&ctx, evictBuffer);
+        printf("gather cold: row hook %.2f us/chunk, Tilemap_get_tile %.2f us/chunk, %.1fx faster\n",
+               rowHook / GATHER_CHUNKS, perTile / GATHER_CHUNKS, rowHook > 0.0 ? perTile / rowHook : 0.0);
+    }
+    
+    chunk_test_context_cleanup(&ctx);
+    free(evictBuffer);
+}
+
+int main(void) {
+    BenchWorld world;
+    if (!chunk_test_world_init(&world, WORLD_SIZE, TILE_ID_COUNT, 0x9e3779b9u)) return 1;
+    
+    printf("chunk %dx%d tiles, %d px tiles, render radius %d, viewport %.0fx%.0f\n",
+           CHUNK_SIZE, CHUNK_SIZE, TILE_SIZE, RENDER_RADIUS, VIEWPORT_WIDTH, VIEWPORT_HEIGHT);
+    printf("%-22s %6s %10s %10s %10s %10s %12s %10s %10s %8s %8s\n",
+           "scenario", "frames", "upd avg", "upd max", "rnd avg", "rnd max",
+           "cmds/frame", "tex new", "peak MiB", "arena", "heap");
+    printf("%-22s %6s %10s %10s %10s %10s %12s %10s %10s %8s %8s\n",
+           "", "", "(us)", "(us)", "(us)", "(us)", "", "", "", "allocs", "allocs");
+    
+    scenario_cold_spawn(&world);
+    scenario_steady_walk(&world, "steady-walk", false);
+    scenario_steady_walk(&world, "steady-walk-prefetch", true);
+    scenario_teleport(&world, "teleport", 1, 4000);
+    scenario_teleport(&world, "teleport-4t", 4, 4000);
+    scenario_teleport(&world, "teleport-unbudgeted-1t", 1, 0);
+    scenario_teleport(&world, "teleport-unbudgeted-2t", 2, 0);
+    scenario_teleport(&world, "teleport-unbudgeted-4t", 4, 0);
+    scenario_teleport(&world, "teleport-unbudgeted-8t", 8, 0);
+    scenario_clustered_observers(&world);
+    scenario_npc_observers(&world);
+    scenario_zoomed_out(&world, "zoomed-out", 0);
+    scenario_zoomed_out(&world, "zoomed-out-paged", 4);
+    scenario_tile_churn(&world);
+    scenario_split_screen(&world);
+    
+    // Crossover: direct wins at high zoom (few visible tiles) and under heavy
+    // edits; cached wins once many tiles are visible and the map is static
+    static const float crossoverZooms[] = {4.0f, 2.0f, 1.0f, 0.5f, 0.25f};
+    for (size_t i = 0; i < sizeof(crossoverZooms) / sizeof(crossoverZooms[0]); i++) {
+        for (int edits = 0; edits <= 64; edits += 64) {
+            scenario_crossover(&world, crossoverZooms[i], CHUNK_RENDER_MODE_CACHED, edits);
+            scenario_crossover(&world, crossoverZooms[i], CHUNK_RENDER_MODE_DIRECT, edits);
+            scenario_crossover(&world, crossoverZooms[i], CHUNK_RENDER_MODE_AUTO, edits);
+        }
+    }
+    
+    // Mostly ocean (tile 0) with one in eight chunks holding a random island
+    BenchWorld ocean;
+    if (!chunk_test_world_init_ocean(&ocean, WORLD_SIZE, CHUNK_SIZE, 8, TILE_ID_COUNT, 0x2545f491u)) return 1;
+    scenario_ocean_walk(&ocean, "ocean-walk", false);
+    scenario_ocean_walk(&ocean, "ocean-walk-dedup", true);
+    chunk_test_world_free(&ocean);
+    
+    BenchTilemap tilemap = {NULL, 0};
+    bool haveTilemap = CHUNK_BENCH_WRAP_TILEMAP && tilemap_init(&tilemap, &world);
+    scenario_rebuild(&world, "rebuild-per-command", false, NULL);
+    scenario_rebuild(&world, "rebuild-batched", true, NULL);
+    if (haveTilemap) {
+        scenario_rebuild(&world, "rebuild-per-tile-fetch", true, &tilemap);
+    }
+    scenario_gather(&world, haveTilemap ? &tilemap : NULL);
+    free(tilemap.tiles);
+    
+    chunk_test_world_free(&world);
+    return 0;
+}
@@ -0,0 +1,35 @@
+#ifndef CHUNK_RENDER_BACKEND_H
+#define CHUNK_RENDER_BACKEND_H
+
+#include "gramarye_renderer/renderer.h"  // RenderCommand, RenderVector2
+#include "gramarye_renderer/camera.h"  // CameraHandle, AspectFitHandle
+#include <stdbool.h>
+
+// Graphics operations used by the chunk render system
+// Every call receives the context passed to ChunkRenderSystem_set_backend.
+// The default backend forwards to the Renderer interface with the Renderer*
+// as context; other backends (e.g. RecordingRenderer) let the system run
+// without a GPU
+typedef struct ChunkRenderBackend {
+    void* (*create_render_texture)(void* context, int width, int height);
+    void (*destroy_render_texture)(void* context, void* renderTexture);
+    void (*begin_render_texture)(void* context, void* renderTexture);
+    void (*end_render_texture)(void* context);
+    void (*execute_command)(void* context, const RenderCommand* command);
+    void* (*get_render_texture_texture)(void* context, void* renderTexture);
+    RenderVector2 (*world_to_screen)(void* context, CameraHandle camera, AspectFitHandle aspectFit, RenderVector2 world);
+    RenderVector2 (*screen_to_world)(void* context, CameraHandle camera, AspectFitHandle aspectFit, RenderVector2 screen);
+    float (*get_camera_zoom)(void* context, CameraHandle camera);
+    float (*get_aspect_fit_scale)(void* context, AspectFitHandle aspectFit);
+    
+    // Optional pixel access used by the disk cache (NULL when unsupported)
+    // Pixels are RGBA8, width * height * 4 bytes, in whatever row order the
+    // backend reads; write must accept the same layout. Return false on failure
+    bool (*read_render_texture)(void* context, void* renderTexture, void* outPixels);
+    bool (*write_render_texture)(void* context, void* renderTexture, const void* pixels);
+} ChunkRenderBackend;
+
+// Backend that forwards to the Renderer interface (context is a Renderer*)
+const ChunkRenderBackend* ChunkRenderBackend_renderer(void);
+
+#endif // CHUNK_RENDER_BACKEND_H
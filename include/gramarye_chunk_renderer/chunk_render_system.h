@@ -13,16 +13,229 @@
 #include "arena.h"
 #include "table.h"
 #include "hash/int_coord_hash.h"
+#include "gramarye_chunk_renderer/chunk_render_backend.h"
+
+// Internal per-chunk record (defined in the library sources)
+typedef struct ChunkSlot ChunkSlot;
+
+// Background tile preparation state (defined in the library sources)
+typedef struct ChunkPrefetch ChunkPrefetch;
+
+// Worker pool owned by the system (defined in the library sources)
+typedef struct ChunkJobPool ChunkJobPool;
+
+// Memory-mapped chunk image cache (defined in the library sources)
+typedef struct ChunkDiskCache ChunkDiskCache;
+
+// Render texture shared by chunks with identical tiles (defined in the library sources)
+typedef struct ChunkSharedTexture ChunkSharedTexture;
+
+// Per-chunk accumulators for batched tile edits (defined in the library sources)
+typedef struct ChunkDirtyBatch ChunkDirtyBatch;
+
+// Observer handle records and chunk buckets (defined in the library sources)
+typedef struct ChunkObserverRecord ChunkObserverRecord;
+typedef struct ChunkObserverBucket ChunkObserverBucket;
+
+// Stable observer handle; 0 is never a valid handle
+typedef uint64_t ChunkObserverHandle;
+
+// One unit of parallel work; index runs over [0, jobCount)
+typedef void (*ChunkRenderJobFn)(void* context, int index);
+
+// Run job(context, i) for every i in [0, jobCount), in any order and on any
+// threads, and return once all of them have finished
+typedef void (*ChunkRenderJobRunFn)(int jobCount,
+                                    ChunkRenderJobFn job,
+                                    void* context,
+                                    void* userData);
+
+// Render-target pool counters (used to size the pool)
+typedef struct ChunkRenderTargetPoolStats {
+    size_t hits;                 // Acquisitions served from the pool
+    size_t misses;               // Acquisitions that created a new target
+    size_t available;            // Targets currently pooled
+    size_t capacity;             // Maximum pooled targets
+} ChunkRenderTargetPoolStats;
+
+// One tile quad in chunk-local pixel space
+typedef struct ChunkTileQuad {
+    RenderRect srcRect;          // Atlas source rectangle
+    RenderRect dstRect;          // Destination inside the chunk render texture
+} ChunkTileQuad;
+
+// Optional batched submission of a chunk's tile quads
+// Called between Renderer_begin_render_texture/Renderer_end_render_texture
+// with every quad of the chunk in one contiguous array. Return false if the
+// backend cannot batch; the system then falls back to one command per tile
+// Render also calls it outside any render texture: in direct mode with the
+// screen-space quads of all visible tiles, and with page packing once per
+// page, where atlasTexture is the page texture and source rects have a
+// negative height (render textures are stored flipped)
+typedef bool (*ChunkRenderBatchSubmitFn)(Renderer* renderer,
+                                         void* atlasTexture,
+                                         const ChunkTileQuad* quads,
+                                         size_t count,
+                                         void* userData);
+
+// Tile id used for cells without a tile
+#define CHUNK_RENDER_EMPTY_TILE (-1)
+
+// Optional bulk tile access: write the tile ids of count consecutive cells
+// starting at (tileX, tileY) into outTileIds, using CHUNK_RENDER_EMPTY_TILE
+// for missing tiles. Return false to fall back to Tilemap_get_tile per cell
+// With a row accessor installed the system may be initialized without a Tilemap
+typedef bool (*ChunkRenderTileRowFn)(Tilemap* tilemap,
+                                     int tileX,
+                                     int tileY,
+                                     int count,
+                                     int* outTileIds,
+                                     void* userData);
+
+// How ChunkRenderSystem_render draws tiles
+typedef enum ChunkRenderMode {
+    CHUNK_RENDER_MODE_CACHED,    // Chunks are cached in render textures (default)
+    CHUNK_RENDER_MODE_DIRECT,    // Visible tiles are drawn from the tilemap every frame
+    CHUNK_RENDER_MODE_AUTO       // Pick per frame from visible tile count and dirty rate
+} ChunkRenderMode;
+
+// Coarsest chunk LOD level (level n is 1/2^n resolution)
+#define CHUNK_RENDER_MAX_LOD_LEVEL 2
+
+// Frames kept for rolling stats
+#define CHUNK_RENDER_STATS_WINDOW 64
+
+// Extra views per system (see ChunkRenderSystem_add_viewport)
+#define CHUNK_RENDER_MAX_VIEWPORTS 8
+
+// One extra view onto the shared chunk cache: its own culling window and LOD level
+typedef struct ChunkRenderViewport {
+    float width;                 // Screen pixels (0 = culling disabled)
+    float height;
+    int lodLevel;                // Level picked by this view's last render
+    bool active;
+    
+    // Chunk window of the last render, merged into the coverage (if hasChunkRect)
+    int chunkMinX;
+    int chunkMinY;
+    int chunkMaxX;
+    int chunkMaxY;
+    bool hasChunkRect;
+} ChunkRenderViewport;
+
+// Work done in one frame (update + render)
+typedef struct ChunkRenderFrameStats {
+    size_t chunksRebuilt;
+    size_t tilesEmitted;         // Tile quads built during rebuilds
+    size_t drawCommands;         // Commands/batches sent to the backend
+    size_t prefetchUploads;      // Rebuilds served by the prefetch worker
+    size_t diskCacheLoads;       // Rebuilds served by the disk cache
+    size_t diskCacheStores;      // Chunk images written to the disk cache
+    size_t dedupHits;            // Rebuilds served by an identical chunk's texture
+    uint64_t updateMicros;       // Wall time in ChunkRenderSystem_update
+    uint64_t renderMicros;       // Wall time in ChunkRenderSystem_render(_viewport)
+} ChunkRenderFrameStats;
+
+// Per-frame means of ChunkRenderFrameStats; fractional, so work done every
+// few frames (e.g. 0.25 rebuilds per frame) does not read as zero
+typedef struct ChunkRenderAverageStats {
+    double chunksRebuilt;
+    double tilesEmitted;
+    double drawCommands;
+    double prefetchUploads;
+    double diskCacheLoads;
+    double diskCacheStores;
+    double dedupHits;
+    double updateMicros;
+    double renderMicros;
+} ChunkRenderAverageStats;
+
+// Snapshot returned by ChunkRenderSystem_get_stats
+// Per-frame and rolling fields stay zero when stats are compiled out
+typedef struct ChunkRenderStats {
+    ChunkRenderFrameStats frame;     // Current frame so far
+    ChunkRenderAverageStats average; // Mean over the rolling window
+    ChunkRenderFrameStats peak;      // Maximum over the rolling window
+    size_t windowFrames;             // Completed frames in the window
+    uint64_t frameNumber;
+    size_t residentChunks;
+    size_t renderTargetBytes;        // Same as ChunkRenderSystem_get_resident_bytes
+    size_t observerCount;
+    size_t rebuildQueueDepth;
+} ChunkRenderStats;
+
+// Trace scope hook; begin/end calls are strictly nested and name is a
+// string literal, so hosts can forward them to their own profiler
+typedef void (*ChunkRenderTraceFn)(const char* name, void* userData);
+
+// Horizontal run of chunks on one chunk row (inclusive bounds)
+typedef struct ChunkSpan {
+    int chunkY;
+    int minChunkX;
+    int maxChunkX;
+} ChunkSpan;
 
 // Chunk render system structure
 typedef struct ChunkRenderSystem {
     Arena_T arena;
     Table_T chunks;              // IntCoord (chunkX, chunkY) -> ChunkRenderData*
     
+    // Residency management (LRU by last visible frame)
+    ChunkSlot* residentHead;     // Least recently visible chunk
+    ChunkSlot* residentTail;     // Most recently visible chunk
+    ChunkSlot* freeSlots;        // Recycled records of evicted chunks
+    size_t residentCount;
+    size_t maxResidentChunks;    // 0 = unlimited
+    size_t maxResidentBytes;     // Render-target bytes, 0 = unlimited
+    
+    // Render-target pool (all chunk targets share one size)
+    void** renderTargetPool;     // Free render textures
+    size_t renderTargetPoolCount;
+    size_t renderTargetPoolCapacity;
+    size_t renderTargetPoolHits;
+    size_t renderTargetPoolMisses;
+    
+    // Rebuild queue (nearest observer first, then most recently dirtied)
+    ChunkSlot** rebuildQueue;
+    size_t rebuildQueueCount;
+    size_t rebuildQueueCapacity;
+    size_t rebuildQueueDepth;    // Chunks left waiting after the last update
+    int maxRebuildsPerFrame;     // 0 = unlimited
+    uint32_t maxRebuildMicros;   // Wall-time budget per update, 0 = unlimited
+    
     // Observer management
+    // Dense arrays share observerCapacity; entity observers come first
     Observer* observers;          // Array of observers
+    IntCoord* observerChunks;     // Current chunk of each observer
+    IntCoord* observerHeadings;   // Unit direction of a chunk crossing not yet scanned for prefetch
+    uint32_t* observerIds;        // Handle record of each observer
     size_t observerCount;
+    size_t entityObserverCount;   // Observers whose Position is polled each update
     size_t observerCapacity;
+    ChunkObserverRecord* observerRecords;  // Handle -> dense index
+    size_t observerRecordCount;
+    size_t observerRecordCapacity;
+    uint32_t observerFreeRecord;  // Free record + 1, 0 = none
+    uint32_t* observerKeys;       // Hashed entity id / manual tile -> record + 1
+    size_t observerKeyCapacity;
+    ChunkObserverBucket* observerBuckets;  // Hashed chunk -> observers standing in it
+    size_t observerBucketCount;
+    size_t observerBucketCapacity;
+    
+    // Merged observer coverage: row-sorted, disjoint chunk spans shared by
+    // update and render, rebuilt only when an observer bucket is created or
+    // emptied or a viewport's chunk window changes
+    ChunkSpan* coverageSpans;
+    size_t coverageSpanCount;
+    size_t coverageSpanCapacity;
+    IntCoord* coverageCenters;   // Distinct observer chunks
+    size_t coverageCenterCount;
+    size_t coverageCenterCapacity;
+    int* coverageHalfWidths;     // Disc half-width per row offset
+    size_t coverageHalfWidthCapacity;
+    int coverageRadius;          // Render radius the half-widths were built for
+    uint64_t coverageFrame;
+    bool coverageValid;
     
     // Configuration
     int chunkSize;               // Tiles per chunk (64x64)
@@ -34,6 +247,104 @@ typedef struct ChunkRenderSystem {
     Tilemap* tilemap;
     Atlas* atlas;
     Renderer* renderer;          // Renderer interface for camera transformations
+    const ChunkRenderBackend* backend;  // Graphics backend (forwards to renderer by default)
+    void* backendContext;        // Passed to every backend call
+    
+    // Arena usage by the system (allocations only happen on growth)
+    size_t arenaAllocations;
+    size_t arenaBytes;
+    
+    // Dense tile_id -> atlas source rect lookup (negative width = not cached)
+    RenderRect* atlasRects;
+    size_t atlasRectCapacity;
+    uint32_t atlasVersion;       // Bumped by ChunkRenderSystem_invalidate_atlas
+    
+    // Chunk rebuild scratch, bulk tile access and optional batched submission
+    int* tileIds;                // chunkSize * chunkSize tile ids, row-major
+    ChunkTileQuad* tileQuads;    // chunkSize * chunkSize quads
+    ChunkRenderTileRowFn tileRowFetch;
+    void* tileRowFetchUserData;
+    ChunkRenderBatchSubmitFn batchSubmit;
+    void* batchSubmitUserData;
+    
+    // Zoom-dependent chunk LOD (see ChunkRenderSystem_set_lod)
+    int lodMaxLevel;             // 0 = always draw full resolution
+    float lodHysteresis;         // Fraction past a threshold before switching
+    int lodLevel;                // Level picked by the last render
+    size_t lodTextureBytes;      // Memory held by LOD textures
+    size_t lodOnlyChunks;        // Resident chunks without a full-resolution target
+    
+    // Page packing (see ChunkRenderSystem_enable_page_packing)
+    int pageChunks;              // Chunks per page side (0 = disabled)
+    void** pages;                // Page render textures
+    size_t pageCount;
+    size_t pageCapacity;
+    int* pageUsedCells;          // Cells in use per page
+    int* pageFreeCells;          // Free cell indices (page * cellsPerPage + cell)
+    size_t pageFreeCount;
+    size_t pageFreeCapacity;
+    ChunkTileQuad* pageDrawQuads;   // Visible paged chunks queued by render
+    int* pageDrawCells;
+    ChunkTileQuad* pageDrawSorted;  // One page's quads, handed to the batch hook
+    size_t pageDrawCount;
+    size_t pageDrawCapacity;
+    size_t pageOnlyChunks;       // Resident chunks without their own target
+    
+    // Render mode (see ChunkRenderSystem_set_render_mode)
+    ChunkRenderMode renderMode;
+    ChunkRenderMode activeRenderMode;  // Path used this frame (never AUTO)
+    size_t directTileThreshold;  // Auto: visible tiles below which direct wins
+    float dirtyTileRate;         // Smoothed tiles marked dirty per update
+    size_t dirtyTilesThisFrame;
+    size_t visibleTiles;         // Tiles inside all views rendered in the last frame
+    size_t frameVisibleTiles;    // Running total for the current frame
+    bool frameRendered;          // A view was rendered since the last update
+    ChunkTileQuad* directQuads;  // Screen-space quads for the direct path
+    size_t directQuadCount;
+    size_t directQuadCapacity;
+    
+    // Viewport used for camera culling in render (0 = culling disabled)
+    float viewportWidth;         // Screen pixels
+    float viewportHeight;
+    
+    // Extra views rendered from the same chunks (see ChunkRenderSystem_add_viewport)
+    ChunkRenderViewport viewports[CHUNK_RENDER_MAX_VIEWPORTS];
+    
+    // Instrumentation (see GRAMARYE_CHUNK_RENDERER_STATS)
+    ChunkRenderFrameStats statsCurrent;
+    ChunkRenderFrameStats statsHistory[CHUNK_RENDER_STATS_WINDOW];
+    size_t statsHistoryNext;
+    size_t statsHistoryCount;
+    ChunkRenderTraceFn traceBegin;
+    ChunkRenderTraceFn traceEnd;
+    void* traceUserData;
+    
+    // Prefetch worker for the ring between renderRadius and simulationRadius
+    ChunkPrefetch* prefetch;     // NULL when disabled
+    
+    // Baked chunk images persisted across evictions and restarts
+    ChunkDiskCache* diskCache;   // NULL when disabled
+    
+    // Chunks with identical tiles share one reference-counted render texture
+    bool dedupEnabled;
+    Table_T sharedTextures;      // Tile hash -> ChunkSharedTexture* (NULL until used)
+    size_t sharedTextureRefs;    // Resident chunks using another chunk's texture
+    
+    // Scratch for ChunkRenderSystem_mark_tiles_dirty, arena-backed and reused
+    ChunkDirtyBatch* dirtyBatch; // NULL until first used
+    
+    // Parallel chunk geometry: quads for a batch of queued chunks are built
+    // by jobRun, then uploaded in queue order on the calling thread
+    ChunkRenderJobRunFn jobRun;  // NULL = build on the calling thread
+    void* jobRunUserData;
+    ChunkJobPool* jobPool;       // Owned pool behind jobRun (NULL if host-provided)
+    ChunkSlot** rebuildBatch;
+    int* batchTileIds;           // rebuildBatchCapacity * chunkSize * chunkSize
+    ChunkTileQuad* batchQuads;   // rebuildBatchCapacity * chunkSize * chunkSize
+    size_t* batchQuadCounts;
+    size_t rebuildBatchCapacity;
+    size_t rebuildBatchSize;     // Chunks built per jobRun call
+    float rebuildChunkMicros;    // Measured batch wall time per chunk (0 = not measured yet)
     
     uint64_t currentFrame;       // Current frame counter
 } ChunkRenderSystem;
@@ -50,13 +361,27 @@ void ChunkRenderSystem_init(ChunkRenderSystem* system,
                             int simulationRadius);
 
 // Add an entity observer (entity must have Position component)
-void ChunkRenderSystem_add_entity_observer(ChunkRenderSystem* system, 
-                                           ECS* ecs,
-                                           EntityId entity,
-                                           ComponentTypeId positionTypeId);
+// Returns the observer's handle (the existing one if already added), 0 on
+// allocation failure
+ChunkObserverHandle ChunkRenderSystem_add_entity_observer(ChunkRenderSystem* system, 
+                                                          ECS* ecs,
+                                                          EntityId entity,
+                                                          ComponentTypeId positionTypeId);
 
 // Add a manual observer at specific tile coordinates
-void ChunkRenderSystem_add_manual_observer(ChunkRenderSystem* system, int tileX, int tileY);
+// Returns the observer's handle (the existing one if already added), 0 on
+// allocation failure
+ChunkObserverHandle ChunkRenderSystem_add_manual_observer(ChunkRenderSystem* system, int tileX, int tileY);
+
+// Move a manual observer (no-op if none is at the old coordinates)
+// Unlike remove + add this keeps the observer's heading for prefetching
+// Moving onto another manual observer's tile removes the moved one
+void ChunkRenderSystem_move_manual_observer(ChunkRenderSystem* system,
+                                            int oldTileX, int oldTileY,
+                                            int newTileX, int newTileY);
+
+// Move a manual observer by handle (no-op for stale or entity handles)
+void ChunkRenderSystem_move_observer(ChunkRenderSystem* system, ChunkObserverHandle handle, int tileX, int tileY);
 
 // Remove an entity observer
 void ChunkRenderSystem_remove_entity_observer(ChunkRenderSystem* system, EntityId entity);
@@ -64,6 +389,14 @@ void ChunkRenderSystem_remove_entity_observer(ChunkRenderSystem* system, EntityI
 // Remove a manual observer at specific tile coordinates
 void ChunkRenderSystem_remove_manual_observer(ChunkRenderSystem* system, int tileX, int tileY);
 
+// Remove an observer by handle (no-op for stale handles)
+void ChunkRenderSystem_remove_observer(ChunkRenderSystem* system, ChunkObserverHandle handle);
+
+// Observers standing in a chunk; writes up to maxHandles handles and
+// returns the total count in that chunk
+size_t ChunkRenderSystem_get_observers_in_chunk(ChunkRenderSystem* system, int chunkX, int chunkY,
+                                                ChunkObserverHandle* outHandles, size_t maxHandles);
+
 // Forward declaration
 typedef struct ChunkManagerSystem ChunkManagerSystem;
 
@@ -75,6 +408,11 @@ void ChunkRenderSystem_update(ChunkRenderSystem* system,
                               ComponentTypeId positionTypeId,
                               ChunkManagerSystem* chunkManager);
 
+// Set the screen viewport size used to cull chunks outside the camera view
+// The viewport corners are mapped with Renderer_screen_to_world; pass 0 to
+// disable culling and draw every loaded chunk around the observers
+void ChunkRenderSystem_set_viewport_size(ChunkRenderSystem* system, float width, float height);
+
 // Render visible chunks
 void ChunkRenderSystem_render(ChunkRenderSystem* system,
                               ECS* ecs,
@@ -82,6 +420,37 @@ void ChunkRenderSystem_render(ChunkRenderSystem* system,
                               CameraHandle camera, 
                               AspectFitHandle aspectFit);
 
+// Add a view that renders from the same resident chunks and rebuild queue
+// For split-screen, minimaps or spectator thumbnails: each view has its own
+// culling window (width x height screen pixels, 0 disables culling) and its
+// own LOD level, while chunks are still rebuilt once per update for all
+// views. The chunks inside a sized view's window are kept resident and
+// rebuilt like those around observers, from the update after its render,
+// so a view can look at areas no observer is near. A window is clamped
+// around its center to as many chunks as one observer's render disc (and
+// to the residency chunk budget), so a zoomed-out view only draws that
+// part plus what observers already keep resident
+// Returns the viewport index, or -1 when all CHUNK_RENDER_MAX_VIEWPORTS are used
+int ChunkRenderSystem_add_viewport(ChunkRenderSystem* system, float width, float height);
+
+// Change a view's culling window size
+void ChunkRenderSystem_resize_viewport(ChunkRenderSystem* system, int viewport, float width, float height);
+
+// Free a viewport index
+void ChunkRenderSystem_remove_viewport(ChunkRenderSystem* system, int viewport);
+
+// Render one view with its own camera; same drawing as ChunkRenderSystem_render
+// Auto render mode decides from the visible tiles of all views in a frame
+void ChunkRenderSystem_render_viewport(ChunkRenderSystem* system,
+                                       int viewport,
+                                       ECS* ecs,
+                                       ComponentTypeId positionTypeId,
+                                       CameraHandle camera,
+                                       AspectFitHandle aspectFit);
+
+// LOD level used by the view's last render
+int ChunkRenderSystem_get_viewport_lod_level(ChunkRenderSystem* system, int viewport);
+
 // Convert tile coordinates to chunk coordinates
 void ChunkRenderSystem_get_chunk_coord(ChunkRenderSystem* system, 
                                        int tileX, int tileY, 
@@ -106,7 +475,209 @@ bool ChunkRenderSystem_handle_click(ChunkRenderSystem* system,
 // Kept for backwards compatibility but should not be used in new code
 void ChunkRenderSystem_mark_chunk_dirty(ChunkRenderSystem* system, int tileX, int tileY);
 
-// Cleanup resources
+// Mark a single tile as changed
+// Only the bounding box of changed tiles is redrawn into the existing
+// render texture; a whole-chunk dirty flag still forces a full redraw
+void ChunkRenderSystem_mark_tile_dirty(ChunkRenderSystem* system, int tileX, int tileY);
+
+// Mark many changed tiles at once (explosions, terraforming, network snapshots)
+// Tiles are grouped by chunk in one pass, so each touched chunk is looked
+// up and flagged once with the bounding box of its changed tiles. A chunk
+// whose box covers it entirely gets a full redraw. Duplicates are fine.
+// Chunks also flagged through a ChunkManagerSystem are redrawn only once
+void ChunkRenderSystem_mark_tiles_dirty(ChunkRenderSystem* system, const IntCoord* tiles, size_t count);
+
+// Mark a rectangle of tiles as changed, starting at (tileX, tileY)
+// Each overlapped chunk is flagged once with its part of the rectangle
+void ChunkRenderSystem_mark_tile_rect_dirty(ChunkRenderSystem* system, int tileX, int tileY,
+                                            int width, int height);
+
+// Fill the atlas lookup table for tile ids [0, tileIdCount) up front
+// Ids outside the prebuilt range are still cached on first use
+void ChunkRenderSystem_rebuild_atlas_lut(ChunkRenderSystem* system, int tileIdCount);
+
+// Set the atlas source rect for a tile id directly
+// Useful for atlases that are not read through Atlas_getRect; entries are
+// dropped again by ChunkRenderSystem_invalidate_atlas
+void ChunkRenderSystem_set_atlas_rect(ChunkRenderSystem* system, int tileId, RenderRect srcRect);
+
+// Drop cached atlas rectangles and mark loaded chunks dirty
+// Call whenever the atlas layout or texture changes (e.g. hot reload)
+// A disk cache is paused until ChunkRenderSystem_set_disk_cache_atlas_key
+void ChunkRenderSystem_invalidate_atlas(ChunkRenderSystem* system);
+
+// Choose how tiles are drawn
+// DIRECT draws the visible tile window from the tilemap through the atlas as
+// one batch every frame and releases all chunk render textures; it suits
+// small maps and close zoom. AUTO switches between DIRECT and CACHED each
+// frame from the visible tile count and the recent dirty-tile rate
+// Direct drawing needs a viewport size to limit the tile window
+void ChunkRenderSystem_set_render_mode(ChunkRenderSystem* system, ChunkRenderMode mode);
+
+// Visible tile count below which AUTO draws directly (0 = default 1024)
+// The limit grows with the number of tiles dirtied per frame
+void ChunkRenderSystem_set_direct_tile_threshold(ChunkRenderSystem* system, int tileCount);
+
+// Path used by the last frame (CACHED or DIRECT)
+ChunkRenderMode ChunkRenderSystem_get_active_render_mode(ChunkRenderSystem* system);
+
+// Pack chunk images into shared page textures of pageChunks x pageChunks
+// chunks (0 disables). Render then draws every visible chunk of a page with
+// one batch-submit call (or a run of commands on the same texture) instead
+// of binding a texture per chunk. Chunks are drawn into their own target,
+// copied into their page cell, and the target goes back to the pool, so a
+// packed chunk is stored once; any later rebuild (even of a few tiles)
+// redraws the whole chunk. Page textures count towards the residency byte
+// budget; trailing pages are destroyed once all their cells are free
+// Full-resolution drawing only: LOD levels above 0 use per-chunk textures,
+// and while LOD is enabled chunks keep their own target as the LOD source
+void ChunkRenderSystem_enable_page_packing(ChunkRenderSystem* system, int pageChunks);
+
+// Enable zoom-dependent chunk LOD up to maxLevel (0 disables)
+// Level 1 draws half-resolution and level 2 quarter-resolution chunk textures
+// once camera zoom * aspect-fit scale drops to 0.5 / 0.25; hysteresis (e.g. 0.1)
+// is how far past a threshold the scale must move before the level changes
+// LOD textures are downsampled from the full-resolution chunk texture during
+// update, only for the levels in use by any view, and redone when the chunk
+// is rebuilt. While no view draws level 0, a chunk whose full-resolution
+// texture has not been drawn for a while gives its target back to the pool;
+// it is redrawn when a view zooms back in (showing its LOD texture until then)
+void ChunkRenderSystem_set_lod(ChunkRenderSystem* system, int maxLevel, float hysteresis);
+
+// LOD level used by the last ChunkRenderSystem_render
+int ChunkRenderSystem_get_lod_level(ChunkRenderSystem* system);
+
+// Replace the graphics backend (NULL restores the Renderer interface)
+// e.g. RecordingRenderer_backend() to run headless without a GPU
+void ChunkRenderSystem_set_backend(ChunkRenderSystem* system,
+                                   const ChunkRenderBackend* backend,
+                                   void* context);
+
+// Install a bulk row accessor for chunk rebuilds (NULL to disable)
+// With a dense tilemap this turns the per-cell lookups into one copy per row
+void ChunkRenderSystem_set_tile_row_fetch(ChunkRenderSystem* system,
+                                          ChunkRenderTileRowFn fetch,
+                                          void* userData);
+
+// Install a batched submission path for chunk rebuilds (NULL to disable)
+void ChunkRenderSystem_set_batch_submit(ChunkRenderSystem* system,
+                                        ChunkRenderBatchSubmitFn submit,
+                                        void* userData);
+
+// Set the per-frame chunk rebuild budget (0 disables a limit)
+// Chunks that do not fit stay queued and keep drawing their previous texture
+// When a time budget is set at least one chunk is rebuilt per update; with
+// worker threads each batch takes only as many chunks as the measured
+// per-chunk cost fits in the time left
+// Queued disk cache writes of evicted chunks use what rebuilds leave over
+void ChunkRenderSystem_set_rebuild_budget(ChunkRenderSystem* system,
+                                          int maxChunksPerFrame,
+                                          uint32_t maxMicrosPerFrame);
+
+// Build chunk geometry on threadCount threads (including the caller)
+// Quads are built in parallel with work stealing and uploaded in queue order
+// on the calling thread, so the output matches a single-threaded build
+// threadCount <= 1 builds on the calling thread again
+// Returns false when worker threads are unavailable
+// The tilemap (or row fetch hook) and Atlas_getRect must be safe to read
+// from several threads; prebuild the atlas lookup table so workers hit it
+bool ChunkRenderSystem_set_worker_threads(ChunkRenderSystem* system, int threadCount);
+
+// Run chunk geometry jobs on a host job system instead (NULL to disable)
+// batchSize: chunks handed to one run call (0 = 16)
+void ChunkRenderSystem_set_job_runner(ChunkRenderSystem* system,
+                                      ChunkRenderJobRunFn run,
+                                      void* userData,
+                                      int batchSize);
+
+// Number of chunks still waiting for a rebuild after the last update
+size_t ChunkRenderSystem_get_rebuild_queue_depth(ChunkRenderSystem* system);
+
+// Set the residency budget (0 disables a limit)
+// Chunks outside every observer's radius are evicted least recently visible
+// first once either limit is exceeded; their render textures are released
+void ChunkRenderSystem_set_residency_budget(ChunkRenderSystem* system,
+                                            size_t maxChunks,
+                                            size_t maxBytes);
+
+// Number of chunks currently resident
+size_t ChunkRenderSystem_get_resident_count(ChunkRenderSystem* system);
+
+// Render-target memory held by resident chunks (including LOD and page textures)
+// and by evicted chunks waiting for their disk cache write, in bytes
+size_t ChunkRenderSystem_get_resident_bytes(ChunkRenderSystem* system);
+
+// Configure the chunk render-target pool
+// capacity: maximum number of free targets kept for reuse
+// prewarmCount: targets created up front (clamped to capacity)
+// Call right after ChunkRenderSystem_init to pre-warm before the first update
+void ChunkRenderSystem_configure_render_target_pool(ChunkRenderSystem* system,
+                                                    size_t capacity,
+                                                    size_t prewarmCount);
+
+// Get render-target pool hit/miss counters
+ChunkRenderTargetPoolStats ChunkRenderSystem_get_render_target_pool_stats(ChunkRenderSystem* system);
+
+// Get per-frame and rolling counters
+ChunkRenderStats ChunkRenderSystem_get_stats(ChunkRenderSystem* system);
+
+// Install trace scope hooks (NULL to disable)
+// Scopes: ChunkRenderSystem_update, chunk_coverage, chunk_rebuild,
+// ChunkRenderSystem_render
+void ChunkRenderSystem_set_trace_hooks(ChunkRenderSystem* system,
+                                       ChunkRenderTraceFn begin,
+                                       ChunkRenderTraceFn end,
+                                       void* userData);
+
+// Start a worker thread that prepares tile quads for chunks in the ring
+// between renderRadius and simulationRadius, ahead of moving observers
+// (nearest first, up to simulationRadius - renderRadius steps along the heading)
+// bufferCount: chunks that can be prepared ahead at once
+// Returns false when threads are unavailable (e.g. web builds without pthreads)
+// The tilemap (or row fetch hook) and Atlas_getRect are then read from the
+// worker, so they must be safe to read while the game thread runs
+bool ChunkRenderSystem_enable_prefetch(ChunkRenderSystem* system, int bufferCount);
+
+// Stop the prefetch worker and drop prepared chunks
+void ChunkRenderSystem_disable_prefetch(ChunkRenderSystem* system);
+
+// Share one render texture between chunks with identical tiles
+// Full rebuilds hash the chunk's tile ids; a chunk matching a registered
+// texture (same tiles, same atlas version) uses it instead of drawing.
+// A shared chunk that becomes dirty gets its own texture and is fully
+// redrawn (copy-on-write). Residency byte budgets count shared textures once
+void ChunkRenderSystem_set_chunk_dedup(ChunkRenderSystem* system, bool enabled);
+
+// Keep baked chunk images in a memory-mapped file at path
+// Full rebuilds hash the chunk's tile ids and upload the stored image
+// instead of drawing when the hash and atlasKey match.
+// Clean chunks are written when flushed or on disable/cleanup. Evicted
+// chunks keep their texture in a short queue that is written during update
+// with whatever the rebuild budget leaves; a full queue writes its oldest
+// image at once
+// A backend without pixel access (such as the default Renderer backend)
+// keeps each chunk's built tile quads instead and draws them on a hit,
+// skipping atlas lookups and quad building; the tile ids are still read
+// to check the hash
+// maxEntries: chunks the file holds (chunk_texture_bytes each for images)
+// atlasKey: identifies the atlas image across runs (e.g. a hash of its file)
+// Returns false if the platform has no mmap or the file cannot be opened
+// An incompatible file (including one of the other format) is reset
+bool ChunkRenderSystem_enable_disk_cache(ChunkRenderSystem* system, const char* path,
+                                         size_t maxEntries, uint64_t atlasKey);
+
+// Key the disk cache to the atlas now in use
+// ChunkRenderSystem_invalidate_atlas pauses the cache (no loads, no stores)
+// until this is called with the key of the reloaded atlas
+void ChunkRenderSystem_set_disk_cache_atlas_key(ChunkRenderSystem* system, uint64_t atlasKey);
+
+// Write every clean resident chunk that is missing or outdated in the cache
+void ChunkRenderSystem_flush_disk_cache(ChunkRenderSystem* system);
+
+// Flush and close the disk cache
+void ChunkRenderSystem_disable_disk_cache(ChunkRenderSystem* system);
+
+// Cleanup resources (releases all chunk and pooled render textures)
 void ChunkRenderSystem_cleanup(ChunkRenderSystem* system);
 
 #endif // CHUNK_RENDER_SYSTEM_H
@@ -0,0 +1,68 @@
+#ifndef RECORDING_RENDERER_H
+#define RECORDING_RENDERER_H
+
+#include "gramarye_chunk_renderer/chunk_render_system.h"  // ChunkRenderBackend, ChunkTileQuad
+#include <stdbool.h>
+#include <stddef.h>
+
+// CPU-only chunk render backend that counts work instead of drawing
+// Lets ChunkRenderSystem run on machines without a GPU (benchmarks, servers)
+//
+// Usage:
+//   RecordingRenderer recorder;
+//   RecordingRenderer_init(&recorder);
+//   ChunkRenderSystem_set_backend(&system, RecordingRenderer_backend(), &recorder);
+//   ChunkRenderSystem_set_batch_submit(&system, RecordingRenderer_submit_batch, &recorder);
+
+// Camera understood by the recording backend (pass its address as CameraHandle)
+typedef struct RecordingCamera {
+    RenderVector2 target;        // World point shown at offset
+    RenderVector2 offset;        // Screen position of target
+    float zoom;
+} RecordingCamera;
+
+// Aspect fit understood by the recording backend (pass its address as AspectFitHandle)
+typedef struct RecordingAspectFit {
+    float scale;
+    RenderVector2 offset;        // Letterbox offset in screen pixels
+} RecordingAspectFit;
+
+typedef struct RecordingRenderer {
+    // Commands
+    size_t commands;             // execute_command calls
+    size_t rectangleCommands;
+    size_t textureCommands;
+    size_t textureProCommands;
+    size_t batches;              // Batched tile submissions
+    size_t batchedQuads;         // Quads received through batches
+    size_t renderTexturePasses;  // begin_render_texture calls
+    size_t pixelReads;           // read_render_texture calls
+    size_t pixelWrites;          // write_render_texture calls
+    
+    // Render textures
+    size_t textureCreations;
+    size_t textureDestructions;
+    size_t liveTextures;
+    size_t liveTextureBytes;     // RGBA8
+    size_t peakTextureBytes;
+    
+    bool inRenderTexture;
+} RecordingRenderer;
+
+// Initialize with all counters at zero
+void RecordingRenderer_init(RecordingRenderer* recorder);
+
+// Reset command counters (texture lifetime counters are kept)
+void RecordingRenderer_reset_commands(RecordingRenderer* recorder);
+
+// Backend table to pass to ChunkRenderSystem_set_backend with the recorder as context
+const ChunkRenderBackend* RecordingRenderer_backend(void);
+
+// ChunkRenderBatchSubmitFn that records one batch per chunk rebuild (userData = recorder)
+bool RecordingRenderer_submit_batch(Renderer* renderer,
+                                    void* atlasTexture,
+                                    const ChunkTileQuad* quads,
+                                    size_t count,
+                                    void* userData);
+
+#endif // RECORDING_RENDERER_H
@@ -0,0 +1,85 @@
+#include "chunk_render_internal.h"
+#include "textures/atlas.h"
+#include <string.h>
+
+static void clear_entries(RenderRect* rects, size_t from, size_t to) {
+    for (size_t i = from; i < to; i++) {
+        rects[i].width = -1.0f;
+    }
+}
+
+static void grow_lut(ChunkRenderSystem* system, size_t needed) {
+    if (needed <= system->atlasRectCapacity) return;
+    
+    size_t newCapacity = system->atlasRectCapacity ? system->atlasRectCapacity : 256;
+    while (newCapacity < needed) {
+        newCapacity *= 2;
+    }
+    RenderRect* rects = (RenderRect*)chunk_arena_alloc(system, sizeof(RenderRect) * newCapacity, __FILE__, __LINE__);
+    if (system->atlasRectCapacity > 0) {
+        memcpy(rects, system->atlasRects, sizeof(RenderRect) * system->atlasRectCapacity);
+    }
+    clear_entries(rects, system->atlasRectCapacity, newCapacity);
+    system->atlasRects = rects;
+    system->atlasRectCapacity = newCapacity;
+}
+
+static RenderRect fetch_rect(ChunkRenderSystem* system, int tileId) {
+    Rectangle r = Atlas_getRect(system->atlas, tileId);
+    RenderRect result = {r.x, r.y, r.width, r.height};
+    return result;
+}
+
+RenderRect chunk_atlas_rect_miss(ChunkRenderSystem* system, int tileId) {
+    if (tileId < 0) {
+        return fetch_rect(system, tileId);
+    }
+    
+    RenderRect rect = fetch_rect(system, tileId);
+    chunk_prefetch_lock_atlas(system);
+    grow_lut(system, (size_t)tileId + 1);
+    system->atlasRects[tileId] = rect;
+    chunk_prefetch_unlock_atlas(system);
+    return rect;
+}
+
+RenderRect chunk_atlas_rect_shared(ChunkRenderSystem* system, int tileId) {
+    if ((unsigned)tileId < system->atlasRectCapacity && system->atlasRects[tileId].width >= 0.0f) {
+        return system->atlasRects[tileId];
+    }
+    return fetch_rect(system, tileId);
+}
+
+void ChunkRenderSystem_rebuild_atlas_lut(ChunkRenderSystem* system, int tileIdCount) {
+    if (!system || !system->atlas || tileIdCount <= 0) return;
+    
+    chunk_prefetch_lock_atlas(system);
+    grow_lut(system, (size_t)tileIdCount);
+    for (int tileId = 0; tileId < tileIdCount; tileId++) {
+        system->atlasRects[tileId] = fetch_rect(system, tileId);
+    }
+    chunk_prefetch_unlock_atlas(system);
+}
+
+void ChunkRenderSystem_set_atlas_rect(ChunkRenderSystem* system, int tileId, RenderRect srcRect) {
+    if (!system || tileId < 0) return;
+    
+    chunk_prefetch_lock_atlas(system);
+    grow_lut(system, (size_t)tileId + 1);
+    system->atlasRects[tileId] = srcRect;
+    chunk_prefetch_unlock_atlas(system);
+}
+
+void ChunkRenderSystem_invalidate_atlas(ChunkRenderSystem* system) {
+    if (!system) return;
+    
+    chunk_prefetch_lock_atlas(system);
+    clear_entries(system->atlasRects, 0, system->atlasRectCapacity);
+    system->atlasVersion++;
+    chunk_prefetch_unlock_atlas(system);
+    
+    // Cached chunk textures were baked with the old atlas
+    for (ChunkSlot* slot = system->residentHead; slot; slot = slot->next) {
+        chunk_mark_slot_dirty(system, slot);
+    }
+}
@@ -0,0 +1,206 @@
+#include "chunk_render_internal.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int span_cmp(const void* a, const void* b) {
+    const ChunkSpan* x = (const ChunkSpan*)a;
+    const ChunkSpan* y = (const ChunkSpan*)b;
+    if (x->chunkY != y->chunkY) return x->chunkY < y->chunkY ? -1 : 1;
+    if (x->minChunkX != y->minChunkX) return x->minChunkX < y->minChunkX ? -1 : 1;
+    return 0;
+}
+
+static void* grow_array(ChunkRenderSystem* system, void* old, size_t count, size_t elementSize, size_t* capacity, size_t needed) {
+    if (needed <= *capacity) return old;
+    
+    size_t newCapacity = *capacity ? *capacity : 16;
+    while (newCapacity < needed) {
+        newCapacity *= 2;
+    }
+    void* grown = chunk_arena_alloc(system, elementSize * newCapacity, __FILE__, __LINE__);
+    if (count > 0) {
+        memcpy(grown, old, elementSize * count);
+    }
+    *capacity = newCapacity;
+    return grown;
+}
+
+// Half-width of the render disc for each row offset, using integer tests
+static void rebuild_half_widths(ChunkRenderSystem* system) {
+    int radius = system->renderRadius < 0 ? 0 : system->renderRadius;
+    size_t rows = (size_t)(2 * radius + 1);
+    system->coverageHalfWidths = (int*)grow_array(system, system->coverageHalfWidths, 0, sizeof(int),
+                                                  &system->coverageHalfWidthCapacity, rows);
+    
+    int radiusSq = radius * radius;
+    int halfWidth = radius;
+    for (int dy = 0; dy <= radius; dy++) {
+        while (halfWidth > 0 && halfWidth * halfWidth + dy * dy > radiusSq) {
+            halfWidth--;
+        }
+        system->coverageHalfWidths[radius + dy] = halfWidth;
+        system->coverageHalfWidths[radius - dy] = halfWidth;
+    }
+    system->coverageRadius = system->renderRadius;
+}
+
+// Chunk window a sized view adds to the coverage. A view adds at most as
+// many chunks as one observer's render disc (and never more than the
+// residency budget), so zooming a view out cannot make the whole world
+// resident; larger windows are shrunk around their center
+static void view_window(const ChunkRenderViewport* view, int64_t limit, ChunkSpan* outRows, int* outRowCount) {
+    int64_t width = (int64_t)view->chunkMaxX - view->chunkMinX + 1;
+    int64_t height = (int64_t)view->chunkMaxY - view->chunkMinY + 1;
+    if ((double)width * (double)height > (double)limit) {
+        // Keep the aspect ratio, with at least one chunk per side
+        double fit = sqrt((double)limit / ((double)width * (double)height));
+        int64_t fitWidth = (int64_t)((double)width * fit);
+        int64_t fitHeight = (int64_t)((double)height * fit);
+        width = fitWidth < 1 ? 1 : (fitWidth > limit ? limit : fitWidth);
+        height = fitHeight < 1 ? 1 : (fitHeight > limit ? limit : fitHeight);
+        while (width * height > limit) {
+            if (width >= height) {
+                width--;
+            } else {
+                height--;
+            }
+        }
+    }
+    
+    int64_t minX = ((int64_t)view->chunkMinX + view->chunkMaxX) / 2 - (width - 1) / 2;
+    int64_t minY = ((int64_t)view->chunkMinY + view->chunkMaxY) / 2 - (height - 1) / 2;
+    outRows->chunkY = (int)minY;
+    outRows->minChunkX = (int)minX;
+    outRows->maxChunkX = (int)(minX + width - 1);
+    *outRowCount = (int)height;
+}
+
+static void rebuild_spans(ChunkRenderSystem* system) {
+    int radius = system->coverageRadius < 0 ? 0 : system->coverageRadius;
+    size_t rows = (size_t)(2 * radius + 1);
+    
+    // One center per occupied chunk bucket; clustered observers share one
+    system->coverageCenters = (IntCoord*)grow_array(system, system->coverageCenters, 0, sizeof(IntCoord),
+                                                    &system->coverageCenterCapacity, system->observerBucketCount);
+    size_t centerCount = chunk_observers_collect_chunks(system, system->coverageCenters);
+    system->coverageCenterCount = centerCount;
+    
+    // Sized viewports add one span per row of their (clamped) chunk window
+    int64_t viewLimit = 0;
+    for (size_t row = 0; row < rows; row++) {
+        viewLimit += 2 * system->coverageHalfWidths[row] + 1;
+    }
+    if (system->maxResidentChunks > 0 && (uint64_t)viewLimit > system->maxResidentChunks) {
+        viewLimit = (int64_t)system->maxResidentChunks;
+    }
+    ChunkSpan viewFirstRows[CHUNK_RENDER_MAX_VIEWPORTS];
+    int viewRowCounts[CHUNK_RENDER_MAX_VIEWPORTS];
+    size_t viewRows = 0;
+    for (int i = 0; i < CHUNK_RENDER_MAX_VIEWPORTS; i++) {
+        const ChunkRenderViewport* view = &system->viewports[i];
+        viewRowCounts[i] = 0;
+        if (view->active && view->hasChunkRect) {
+            view_window(view, viewLimit, &viewFirstRows[i], &viewRowCounts[i]);
+            viewRows += (size_t)viewRowCounts[i];
+        }
+    }
+    
+    system->coverageSpans = (ChunkSpan*)grow_array(system, system->coverageSpans, 0, sizeof(ChunkSpan),
+                                                   &system->coverageSpanCapacity, centerCount * rows + viewRows);
+    size_t spanCount = 0;
+    for (size_t i = 0; i < centerCount; i++) {
+        IntCoord center = system->coverageCenters[i];
+        for (int dy = -radius; dy <= radius; dy++) {
+            int halfWidth = system->coverageHalfWidths[radius + dy];
+            ChunkSpan span = {center.y + dy, center.x - halfWidth, center.x + halfWidth};
+            system->coverageSpans[spanCount++] = span;
+        }
+    }
+    for (int i = 0; i < CHUNK_RENDER_MAX_VIEWPORTS; i++) {
+        for (int row = 0; row < viewRowCounts[i]; row++) {
+            ChunkSpan span = viewFirstRows[i];
+            span.chunkY += row;
+            system->coverageSpans[spanCount++] = span;
+        }
+    }
+    
+    // Sort by row then start, and merge overlapping or touching spans
+    if (spanCount > 1) {
+        qsort(system->coverageSpans, spanCount, sizeof(ChunkSpan), span_cmp);
+    }
+    size_t merged = 0;
+    for (size_t i = 0; i < spanCount; i++) {
+        ChunkSpan span = system->coverageSpans[i];
+        if (merged > 0) {
+            ChunkSpan* last = &system->coverageSpans[merged - 1];
+            if (last->chunkY == span.chunkY && span.minChunkX <= last->maxChunkX + 1) {
+                if (span.maxChunkX > last->maxChunkX) {
+                    last->maxChunkX = span.maxChunkX;
+                }
+                continue;
+            }
+        }
+        system->coverageSpans[merged++] = span;
+    }
+    system->coverageSpanCount = merged;
+}
+
+void chunk_coverage_prepare(ChunkRenderSystem* system, ECS* ecs, ComponentTypeId positionTypeId) {
+    if (system->coverageValid && system->coverageFrame == system->currentFrame) return;
+    
+    // Observers moving between already occupied chunks leave the spans
+    // alone; bucket changes invalidate the coverage
+    chunk_observers_poll(system, ecs, positionTypeId);
+    bool changed = !system->coverageValid || system->coverageRadius != system->renderRadius;
+    
+    if (changed) {
+        if (system->coverageRadius != system->renderRadius || !system->coverageHalfWidths) {
+            rebuild_half_widths(system);
+        }
+        rebuild_spans(system);
+    }
+    
+    system->coverageValid = true;
+    system->coverageFrame = system->currentFrame;
+}
+
+void chunk_coverage_invalidate(ChunkRenderSystem* system) {
+    system->coverageValid = false;
+}
+
+void chunk_coverage_set_view(ChunkRenderSystem* system, ChunkRenderViewport* view, bool hasRect,
+                             int chunkMinX, int chunkMinY, int chunkMaxX, int chunkMaxY) {
+    if (!hasRect) {
+        if (view->hasChunkRect) {
+            view->hasChunkRect = false;
+            chunk_coverage_invalidate(system);
+        }
+        return;
+    }
+    if (view->hasChunkRect && view->chunkMinX == chunkMinX && view->chunkMinY == chunkMinY &&
+        view->chunkMaxX == chunkMaxX && view->chunkMaxY == chunkMaxY) {
+        return;
+    }
+    view->chunkMinX = chunkMinX;
+    view->chunkMinY = chunkMinY;
+    view->chunkMaxX = chunkMaxX;
+    view->chunkMaxY = chunkMaxY;
+    view->hasChunkRect = true;
+    chunk_coverage_invalidate(system);
+}
+
+int64_t chunk_coverage_nearest_dist_sq(ChunkRenderSystem* system, int chunkX, int chunkY) {
+    int64_t best = INT64_MAX;
+    for (size_t i = 0; i < system->coverageCenterCount; i++) {
+        // 64-bit so far chunks (teleports, large worlds) cannot overflow
+        int64_t dx = (int64_t)chunkX - system->coverageCenters[i].x;
+        int64_t dy = (int64_t)chunkY - system->coverageCenters[i].y;
+        int64_t distSq = dx * dx + dy * dy;
+        if (distSq < best) {
+            best = distSq;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,137 @@
+#include "chunk_render_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Content deduplication
+// Every fully rebuilt chunk registers its texture under the hash of its
+// tile ids. A later chunk with the same tiles (and atlas version) drops its
+// own target and references the registered texture instead of drawing.
+// Shared textures are reference counted; a chunk that needs redrawing is
+// split off first (copy-on-write), so the other chunks keep their image
+
+struct ChunkSharedTexture {
+    uint64_t hash;               // Table key
+    void* renderTexture;
+    int* tileIds;                // chunkSize * chunkSize ids, checked on every hit
+    uint32_t atlasVersion;
+    int refCount;
+    bool registered;             // Still the table entry for its hash
+};
+
+static int hash_cmp(const void* a, const void* b) {
+    return *(const uint64_t*)a != *(const uint64_t*)b;
+}
+
+static unsigned hash_hash(const void* key) {
+    uint64_t hash = *(const uint64_t*)key;
+    return (unsigned)(hash ^ (hash >> 32));
+}
+
+static size_t chunk_tile_count(ChunkRenderSystem* system) {
+    return (size_t)system->chunkSize * (size_t)system->chunkSize;
+}
+
+static void unregister_shared(ChunkRenderSystem* system, ChunkSharedTexture* shared) {
+    if (shared->registered) {
+        Table_remove(system->sharedTextures, &shared->hash);
+    }
+    free(shared->tileIds);
+    free(shared);
+}
+
+bool chunk_dedup_share(ChunkRenderSystem* system, ChunkSlot* slot, const int* tileIds) {
+    if (!system->dedupEnabled || !system->sharedTextures || !slot->hasContentHash) return false;
+    
+    ChunkSharedTexture* shared = (ChunkSharedTexture*)Table_get(system->sharedTextures, &slot->contentHash);
+    if (!shared || shared->atlasVersion != system->atlasVersion ||
+        memcmp(shared->tileIds, tileIds, sizeof(int) * chunk_tile_count(system)) != 0) {
+        return false;
+    }
+    
+    chunk_render_target_release(system, slot->data.renderTexture);
+    slot->data.renderTexture = shared->renderTexture;
+    slot->sharedTexture = shared;
+    shared->refCount++;
+    system->sharedTextureRefs++;
+    CHUNK_STAT_ADD(system, dedupHits, 1);
+    return true;
+}
+
+void chunk_dedup_register(ChunkRenderSystem* system, ChunkSlot* slot, const int* tileIds) {
+    if (!system->dedupEnabled || !slot->hasContentHash || slot->sharedTexture) return;
+    if (!system->sharedTextures) {
+        system->sharedTextures = Table_new(256, hash_cmp, hash_hash);
+    }
+    
+    // Equal hashes with different tiles stay unshared; an entry baked with
+    // an older atlas gives way, its remaining users keep it until redrawn
+    ChunkSharedTexture* existing = (ChunkSharedTexture*)Table_get(system->sharedTextures, &slot->contentHash);
+    if (existing) {
+        if (existing->atlasVersion == system->atlasVersion) return;
+        Table_remove(system->sharedTextures, &existing->hash);
+        existing->registered = false;
+    }
+    
+    ChunkSharedTexture* shared = (ChunkSharedTexture*)malloc(sizeof(ChunkSharedTexture));
+    int* ids = (int*)malloc(sizeof(int) * chunk_tile_count(system));
+    if (!shared || !ids) {
+        free(shared);
+        free(ids);
+        return;
+    }
+    memcpy(ids, tileIds, sizeof(int) * chunk_tile_count(system));
+    shared->hash = slot->contentHash;
+    shared->renderTexture = slot->data.renderTexture;
+    shared->tileIds = ids;
+    shared->atlasVersion = system->atlasVersion;
+    shared->refCount = 1;
+    shared->registered = true;
+    Table_put(system->sharedTextures, &shared->hash, shared);
+    slot->sharedTexture = shared;
+}
+
+bool chunk_dedup_detach(ChunkRenderSystem* system, ChunkSlot* slot) {
+    ChunkSharedTexture* shared = slot->sharedTexture;
+    if (!shared) return false;
+    slot->sharedTexture = NULL;
+    
+    // Sole owner: the texture stays, but its content is about to change
+    if (shared->refCount == 1) {
+        chunk_disk_cache_settle(system, slot->data.renderTexture);
+        unregister_shared(system, shared);
+        return false;
+    }
+    
+    shared->refCount--;
+    system->sharedTextureRefs--;
+    slot->data.renderTexture = chunk_render_target_acquire(system);
+    return true;
+}
+
+bool chunk_dedup_release(ChunkRenderSystem* system, ChunkSlot* slot) {
+    ChunkSharedTexture* shared = slot->sharedTexture;
+    if (!shared) return false;
+    slot->sharedTexture = NULL;
+    
+    if (shared->refCount == 1) {
+        unregister_shared(system, shared);
+        return false;
+    }
+    shared->refCount--;
+    system->sharedTextureRefs--;
+    return true;
+}
+
+void chunk_dedup_release_all(ChunkRenderSystem* system) {
+    // Every entry is referenced by a resident chunk, so releasing the
+    // residents first leaves the table empty
+    if (system->sharedTextures) {
+        Table_free(&system->sharedTextures);
+    }
+    system->sharedTextureRefs = 0;
+}
+
+void ChunkRenderSystem_set_chunk_dedup(ChunkRenderSystem* system, bool enabled) {
+    if (!system) return;
+    system->dedupEnabled = enabled;
+}
@@ -0,0 +1,111 @@
+#include "chunk_render_internal.h"
+#include <string.h>
+
+// Defaults from the crossover scenarios in bench/chunk_renderer_bench.c:
+// a static view is cheaper cached above roughly a thousand visible tiles,
+// and re-rasterizing one dirty tile costs about as much as drawing ~32
+// tiles directly
+#define DEFAULT_DIRECT_TILE_THRESHOLD 1024
+#define DIRTY_TILE_WEIGHT 32.0f
+#define DIRTY_RATE_SMOOTHING 0.1f    // Weight of the newest frame in the dirty rate
+#define AUTO_MODE_HYSTERESIS 0.2f
+
+bool chunk_direct_available(ChunkRenderSystem* system) {
+    return (system->tilemap || system->tileRowFetch) && system->atlas && system->backendContext;
+}
+
+void chunk_direct_queue(ChunkRenderSystem* system, int chunkX, int chunkY, const ChunkTileRegion* region,
+                        RenderVector2 chunkScreenPos, float pixelScale) {
+    chunk_gather_tile_ids(system, chunkX, chunkY, region, system->tileIds);
+    size_t count = chunk_build_tile_quads(system, system->tileIds, region, system->tileQuads, false);
+    if (count == 0) return;
+    
+    size_t needed = system->directQuadCount + count;
+    if (needed > system->directQuadCapacity) {
+        size_t newCapacity = system->directQuadCapacity ? system->directQuadCapacity : 1024;
+        while (newCapacity < needed) {
+            newCapacity *= 2;
+        }
+        ChunkTileQuad* quads = (ChunkTileQuad*)chunk_arena_alloc(system, sizeof(ChunkTileQuad) * newCapacity, __FILE__, __LINE__);
+        if (system->directQuadCount > 0) {
+            memcpy(quads, system->directQuads, sizeof(ChunkTileQuad) * system->directQuadCount);
+        }
+        system->directQuads = quads;
+        system->directQuadCapacity = newCapacity;
+    }
+    
+    // Chunk-local pixel quads -> screen space
+    ChunkTileQuad* out = system->directQuads + system->directQuadCount;
+    for (size_t i = 0; i < count; i++) {
+        out[i].srcRect = system->tileQuads[i].srcRect;
+        out[i].dstRect.x = chunkScreenPos.x + system->tileQuads[i].dstRect.x * pixelScale;
+        out[i].dstRect.y = chunkScreenPos.y + system->tileQuads[i].dstRect.y * pixelScale;
+        out[i].dstRect.width = system->tileQuads[i].dstRect.width * pixelScale;
+        out[i].dstRect.height = system->tileQuads[i].dstRect.height * pixelScale;
+    }
+    system->directQuadCount = needed;
+}
+
+void chunk_direct_flush(ChunkRenderSystem* system) {
+    if (system->directQuadCount > 0) {
+        chunk_submit_tile_quads(system, system->directQuads, system->directQuadCount);
+    }
+    system->directQuadCount = 0;
+}
+
+void chunk_direct_note_dirty(ChunkRenderSystem* system, size_t tiles) {
+    system->dirtyTilesThisFrame += tiles;
+}
+
+void chunk_direct_end_update(ChunkRenderSystem* system) {
+    system->dirtyTileRate += ((float)system->dirtyTilesThisFrame - system->dirtyTileRate) * DIRTY_RATE_SMOOTHING;
+    system->dirtyTilesThisFrame = 0;
+}
+
+void chunk_direct_select_mode(ChunkRenderSystem* system, size_t visibleTiles) {
+    system->visibleTiles = visibleTiles;
+    if (system->renderMode != CHUNK_RENDER_MODE_AUTO) return;
+    
+    // Drawing tiles directly costs the visible tiles every frame; caching
+    // costs re-rasterizing whatever changed, so a high dirty rate raises the
+    // window size up to which direct drawing wins
+    float limit = (float)system->directTileThreshold + system->dirtyTileRate * DIRTY_TILE_WEIGHT;
+    float visible = (float)visibleTiles;
+    
+    if (system->activeRenderMode == CHUNK_RENDER_MODE_DIRECT) {
+        if (visible > limit * (1.0f + AUTO_MODE_HYSTERESIS)) {
+            system->activeRenderMode = CHUNK_RENDER_MODE_CACHED;
+        }
+    } else if (visible < limit * (1.0f - AUTO_MODE_HYSTERESIS) && chunk_direct_available(system)) {
+        system->activeRenderMode = CHUNK_RENDER_MODE_DIRECT;
+    }
+}
+
+void ChunkRenderSystem_set_render_mode(ChunkRenderSystem* system, ChunkRenderMode mode) {
+    if (!system) return;
+    system->renderMode = mode;
+    if (system->directTileThreshold == 0) {
+        system->directTileThreshold = DEFAULT_DIRECT_TILE_THRESHOLD;
+    }
+    
+    if (mode == CHUNK_RENDER_MODE_DIRECT) {
+        // No chunk textures are used at all, so give their memory back
+        system->activeRenderMode = CHUNK_RENDER_MODE_DIRECT;
+        chunk_residency_release_all(system);
+        chunk_page_release_all(system);
+        chunk_render_target_pool_release_all(system);
+    } else if (mode == CHUNK_RENDER_MODE_CACHED) {
+        system->activeRenderMode = CHUNK_RENDER_MODE_CACHED;
+    }
+    // Auto keeps the current path until the next update decides
+}
+
+void ChunkRenderSystem_set_direct_tile_threshold(ChunkRenderSystem* system, int tileCount) {
+    if (!system) return;
+    system->directTileThreshold = tileCount > 0 ? (size_t)tileCount : DEFAULT_DIRECT_TILE_THRESHOLD;
+}
+
+ChunkRenderMode ChunkRenderSystem_get_active_render_mode(ChunkRenderSystem* system) {
+    if (!system) return CHUNK_RENDER_MODE_CACHED;
+    return system->activeRenderMode;
+}
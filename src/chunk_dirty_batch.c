@@ -0,0 +1,187 @@
+#include "chunk_render_internal.h"
+#include <limits.h>
+#include <string.h>
+
+// Batched tile edits
+// A batch of changed tiles is folded into one accumulator per chunk: an
+// open-addressing index maps chunk coordinates to the accumulator, which
+// keeps the bounding box of that chunk's tiles. Each chunk is then looked
+// up in system->chunks and flagged once. The scratch lives in the system
+// arena, is kept for the next batch and only the used index buckets are
+// cleared
+
+typedef struct ChunkDirtyEntry {
+    int chunkX;
+    int chunkY;
+    int minX;                    // Chunk-local bounding box of changed tiles
+    int minY;
+    int maxX;
+    int maxY;
+    size_t bucket;               // Index bucket holding this entry
+} ChunkDirtyEntry;
+
+struct ChunkDirtyBatch {
+    ChunkDirtyEntry* entries;
+    size_t count;
+    size_t capacity;
+    uint32_t* index;             // Entry + 1 per bucket, 0 = empty
+    size_t indexCapacity;        // Power of two
+};
+
+static int floor_div(int value, int divisor) {
+    return value >= 0 ? value / divisor : (value - divisor + 1) / divisor;
+}
+
+static size_t home_bucket(int chunkX, int chunkY, size_t mask) {
+    uint64_t key = ((uint64_t)(uint32_t)chunkX << 32) | (uint32_t)chunkY;
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return (size_t)key & mask;
+}
+
+static void grow_index(ChunkRenderSystem* system, ChunkDirtyBatch* batch) {
+    size_t capacity = batch->indexCapacity ? batch->indexCapacity * 2 : 64;
+    uint32_t* index = (uint32_t*)chunk_arena_alloc(system, sizeof(uint32_t) * capacity, __FILE__, __LINE__);
+    memset(index, 0, sizeof(uint32_t) * capacity);
+    
+    for (size_t i = 0; i < batch->count; i++) {
+        ChunkDirtyEntry* entry = &batch->entries[i];
+        size_t bucket = home_bucket(entry->chunkX, entry->chunkY, capacity - 1);
+        while (index[bucket]) {
+            bucket = (bucket + 1) & (capacity - 1);
+        }
+        index[bucket] = (uint32_t)(i + 1);
+        entry->bucket = bucket;
+    }
+    batch->index = index;
+    batch->indexCapacity = capacity;
+}
+
+// Accumulator for a chunk, added on first use
+static ChunkDirtyEntry* batch_entry(ChunkRenderSystem* system, ChunkDirtyBatch* batch, int chunkX, int chunkY) {
+    if ((batch->count + 1) * 2 > batch->indexCapacity) {
+        grow_index(system, batch);
+    }
+    
+    size_t mask = batch->indexCapacity - 1;
+    size_t bucket = home_bucket(chunkX, chunkY, mask);
+    while (batch->index[bucket]) {
+        ChunkDirtyEntry* entry = &batch->entries[batch->index[bucket] - 1];
+        if (entry->chunkX == chunkX && entry->chunkY == chunkY) {
+            return entry;
+        }
+        bucket = (bucket + 1) & mask;
+    }
+    
+    if (batch->count == batch->capacity) {
+        size_t capacity = batch->capacity ? batch->capacity * 2 : 64;
+        ChunkDirtyEntry* entries = (ChunkDirtyEntry*)chunk_arena_alloc(system, sizeof(ChunkDirtyEntry) * capacity, __FILE__, __LINE__);
+        if (batch->count > 0) {
+            memcpy(entries, batch->entries, sizeof(ChunkDirtyEntry) * batch->count);
+        }
+        batch->entries = entries;
+        batch->capacity = capacity;
+    }
+    
+    ChunkDirtyEntry* entry = &batch->entries[batch->count++];
+    entry->chunkX = chunkX;
+    entry->chunkY = chunkY;
+    entry->minX = INT_MAX;
+    entry->minY = INT_MAX;
+    entry->maxX = INT_MIN;
+    entry->maxY = INT_MIN;
+    entry->bucket = bucket;
+    batch->index[bucket] = (uint32_t)batch->count;
+    return entry;
+}
+
+static void mark_chunk_region(ChunkRenderSystem* system, int chunkX, int chunkY, const ChunkTileRegion* region) {
+    chunk_prefetch_invalidate(system, chunkX, chunkY);
+    
+    IntCoord coord = {chunkX, chunkY};
+    ChunkSlot* slot = (ChunkSlot*)Table_get(system->chunks, &coord);
+    if (!slot) return;
+    
+    if (region->width == system->chunkSize && region->height == system->chunkSize) {
+        chunk_mark_slot_dirty(system, slot);
+    } else {
+        chunk_mark_slot_region_dirty(system, slot, region);
+    }
+}
+
+void ChunkRenderSystem_mark_tiles_dirty(ChunkRenderSystem* system, const IntCoord* tiles, size_t count) {
+    if (!system || !tiles || count == 0) return;
+    
+    if (!system->dirtyBatch) {
+        system->dirtyBatch = (ChunkDirtyBatch*)chunk_arena_alloc(system, sizeof(ChunkDirtyBatch), __FILE__, __LINE__);
+        memset(system->dirtyBatch, 0, sizeof(ChunkDirtyBatch));
+    }
+    ChunkDirtyBatch* batch = system->dirtyBatch;
+    
+    // Edits usually arrive in runs within one chunk, so the last
+    // accumulator is tried before the index
+    ChunkDirtyEntry* last = NULL;
+    for (size_t i = 0; i < count; i++) {
+        int chunkX = floor_div(tiles[i].x, system->chunkSize);
+        int chunkY = floor_div(tiles[i].y, system->chunkSize);
+        ChunkDirtyEntry* entry = last;
+        if (!entry || entry->chunkX != chunkX || entry->chunkY != chunkY) {
+            entry = batch_entry(system, batch, chunkX, chunkY);
+        }
+        
+        int localX = tiles[i].x - chunkX * system->chunkSize;
+        int localY = tiles[i].y - chunkY * system->chunkSize;
+        if (localX < entry->minX) entry->minX = localX;
+        if (localY < entry->minY) entry->minY = localY;
+        if (localX > entry->maxX) entry->maxX = localX;
+        if (localY > entry->maxY) entry->maxY = localY;
+        last = entry;
+    }
+    
+    // The dirty rate counts the redrawn boxes, so repeated tiles count once
+    size_t dirtyTiles = 0;
+    for (size_t i = 0; i < batch->count; i++) {
+        ChunkDirtyEntry* entry = &batch->entries[i];
+        ChunkTileRegion region = {entry->minX, entry->minY,
+                                  entry->maxX - entry->minX + 1, entry->maxY - entry->minY + 1};
+        mark_chunk_region(system, entry->chunkX, entry->chunkY, &region);
+        dirtyTiles += (size_t)region.width * (size_t)region.height;
+        batch->index[entry->bucket] = 0;
+    }
+    batch->count = 0;
+    chunk_direct_note_dirty(system, dirtyTiles);
+}
+
+void ChunkRenderSystem_mark_tile_rect_dirty(ChunkRenderSystem* system, int tileX, int tileY,
+                                            int width, int height) {
+    if (!system || width <= 0 || height <= 0) return;
+    
+    int maxTileX = tileX + (width - 1);
+    int maxTileY = tileY + (height - 1);
+    int minChunkX = floor_div(tileX, system->chunkSize);
+    int minChunkY = floor_div(tileY, system->chunkSize);
+    int maxChunkX = floor_div(maxTileX, system->chunkSize);
+    int maxChunkY = floor_div(maxTileY, system->chunkSize);
+    
+    for (int chunkY = minChunkY; chunkY <= maxChunkY; chunkY++) {
+        int originY = chunkY * system->chunkSize;
+        int minY = tileY > originY ? tileY - originY : 0;
+        int maxY = maxTileY < originY + system->chunkSize - 1 ? maxTileY - originY : system->chunkSize - 1;
+        
+        for (int chunkX = minChunkX; chunkX <= maxChunkX; chunkX++) {
+            int originX = chunkX * system->chunkSize;
+            int minX = tileX > originX ? tileX - originX : 0;
+            int maxX = maxTileX < originX + system->chunkSize - 1 ? maxTileX - originX : system->chunkSize - 1;
+            
+            ChunkTileRegion region = {minX, minY, maxX - minX + 1, maxY - minY + 1};
+            mark_chunk_region(system, chunkX, chunkY, &region);
+        }
+    }
+    chunk_direct_note_dirty(system, (size_t)width * (size_t)height);
+}
+
+void chunk_dirty_batch_release(ChunkRenderSystem* system) {
+    // The scratch lives in the caller's arena
+    system->dirtyBatch = NULL;
+}
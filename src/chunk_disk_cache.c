@@ -0,0 +1,499 @@
+#define _POSIX_C_SOURCE 200809L
+#define _FILE_OFFSET_BITS 64
+#include "chunk_render_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Persistent cache of baked chunks in one memory-mapped file
+// Layout: header, a fixed table of entry records, then one chunk image per
+// record. Backends without pixel access store the chunk's built tile quads
+// in place of the image, and a hit draws them instead of rebuilding.
+// Records are found by chunk coordinate (a short linear probe from the
+// coordinate's home record) and only used when the stored content hash
+// and atlas key match. The file is native-endian; a mismatched magic,
+// version or geometry discards it
+// The in-process atlas version is never written: once the atlas is
+// invalidated the cache neither loads nor stores until the host sets a key
+// for the new atlas
+// Evicted chunks are not read back on the spot: their texture (or just their
+// coordinate, for quads) is queued and written by chunk_disk_cache_drain
+// under the rebuild budget
+
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(__EMSCRIPTEN__)
+#define CHUNK_RENDER_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define CHUNK_RENDER_HAS_MMAP 0
+#endif
+
+#if CHUNK_RENDER_HAS_MMAP
+
+#define DISK_CACHE_MAGIC "GCRCACHE"
+#define DISK_CACHE_VERSION 3u
+#define DISK_CACHE_PROBE 8       // Records tried per coordinate
+#define DISK_CACHE_ALIGN 4096    // Images start on a page boundary
+#define DISK_CACHE_QUEUE 32      // Evicted chunks waiting to be written
+
+typedef enum DiskCacheFormat {
+    DISK_CACHE_PIXELS = 1,       // RGBA8 chunk images (backend has pixel access)
+    DISK_CACHE_QUADS = 2         // Built ChunkTileQuads, quadCount per record
+} DiskCacheFormat;
+
+typedef struct DiskCacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t entryCount;
+    int32_t tileSize;
+    int32_t chunkSize;
+    uint32_t format;             // DiskCacheFormat
+    uint32_t reserved;
+    uint64_t imageBytes;         // Bytes per chunk image or quad array
+    uint64_t imageOffset;        // File offset of the first image
+} DiskCacheHeader;
+
+typedef struct DiskCacheEntry {
+    int32_t chunkX;
+    int32_t chunkY;
+    uint32_t valid;              // 0 while empty or being written
+    uint32_t quadCount;          // Quads stored (quads format)
+    uint64_t atlasKey;
+    uint64_t contentHash;        // chunk_tile_hash of the chunk's tile ids
+} DiskCacheEntry;
+
+// Image of an evicted chunk, read back when the queue is drained
+// The texture is borrowed while other chunks still share it (dedup) and
+// owned once it would have gone back to the pool. Quad stores hold no
+// texture; their quads are built again from the tilemap when written
+typedef struct DiskCacheStore {
+    void* renderTexture;         // NULL for quads
+    bool written;                // Written early by chunk_disk_cache_settle
+    int chunkX;
+    int chunkY;
+    uint64_t contentHash;
+    uint32_t atlasVersion;       // Atlas version the texture was drawn with
+    bool owned;
+} DiskCacheStore;
+
+struct ChunkDiskCache {
+    int fd;
+    unsigned char* base;
+    size_t size;
+    DiskCacheHeader* header;
+    DiskCacheEntry* entries;
+    DiskCacheFormat format;
+    uint64_t atlasKey;
+    uint32_t keyVersion;         // Atlas version atlasKey was set for
+    DiskCacheStore pending[DISK_CACHE_QUEUE];  // Ring, oldest at pendingHead
+    size_t pendingHead;
+    size_t pendingCount;
+};
+
+static uint64_t image_offset(uint32_t entryCount) {
+    uint64_t end = sizeof(DiskCacheHeader) + (uint64_t)entryCount * sizeof(DiskCacheEntry);
+    return (end + DISK_CACHE_ALIGN - 1) / DISK_CACHE_ALIGN * DISK_CACHE_ALIGN;
+}
+
+static unsigned char* entry_image(ChunkDiskCache* cache, const DiskCacheEntry* entry) {
+    size_t index = (size_t)(entry - cache->entries);
+    return cache->base + cache->header->imageOffset + (uint64_t)index * cache->header->imageBytes;
+}
+
+static size_t home_entry(ChunkDiskCache* cache, int chunkX, int chunkY) {
+    uint64_t key = ((uint64_t)(uint32_t)chunkX << 32) | (uint32_t)chunkY;
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return (size_t)(key % cache->header->entryCount);
+}
+
+// Record holding this coordinate, or NULL
+static DiskCacheEntry* find_entry(ChunkDiskCache* cache, int chunkX, int chunkY) {
+    uint32_t count = cache->header->entryCount;
+    size_t index = home_entry(cache, chunkX, chunkY);
+    for (uint32_t probe = 0; probe < DISK_CACHE_PROBE && probe < count; probe++) {
+        DiskCacheEntry* entry = &cache->entries[index];
+        if (entry->valid && entry->chunkX == chunkX && entry->chunkY == chunkY) {
+            return entry;
+        }
+        index = (index + 1) % count;
+    }
+    return NULL;
+}
+
+// First free record in the probe window; the home record is overwritten
+// when the window is full
+static DiskCacheEntry* claim_entry(ChunkDiskCache* cache, int chunkX, int chunkY) {
+    uint32_t count = cache->header->entryCount;
+    size_t home = home_entry(cache, chunkX, chunkY);
+    size_t index = home;
+    for (uint32_t probe = 0; probe < DISK_CACHE_PROBE && probe < count; probe++) {
+        if (!cache->entries[index].valid) {
+            return &cache->entries[index];
+        }
+        index = (index + 1) % count;
+    }
+    return &cache->entries[home];
+}
+
+static bool header_matches(const DiskCacheHeader* header, uint32_t entryCount, int tileSize,
+                           int chunkSize, DiskCacheFormat format, uint64_t imageBytes) {
+    return memcmp(header->magic, DISK_CACHE_MAGIC, sizeof(header->magic)) == 0 &&
+           header->version == DISK_CACHE_VERSION &&
+           header->entryCount == entryCount &&
+           header->tileSize == tileSize &&
+           header->chunkSize == chunkSize &&
+           header->format == (uint32_t)format &&
+           header->imageBytes == imageBytes &&
+           header->imageOffset == image_offset(entryCount);
+}
+
+static void close_cache(ChunkDiskCache* cache) {
+    if (cache->base) {
+        msync(cache->base, cache->size, MS_ASYNC);
+        munmap(cache->base, cache->size);
+    }
+    if (cache->fd >= 0) {
+        close(cache->fd);
+    }
+    free(cache);
+}
+
+static ChunkDiskCache* open_cache(const char* path, uint32_t entryCount, int tileSize,
+                                  int chunkSize, DiskCacheFormat format, uint64_t imageBytes) {
+    uint64_t fileSize = image_offset(entryCount) + (uint64_t)entryCount * imageBytes;
+    if (fileSize > (uint64_t)SIZE_MAX) return NULL;
+    
+    ChunkDiskCache* cache = (ChunkDiskCache*)calloc(1, sizeof(ChunkDiskCache));
+    if (!cache) return NULL;
+    cache->fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (cache->fd < 0) {
+        close_cache(cache);
+        return NULL;
+    }
+    
+    // Keep a compatible file; anything else is truncated and started over
+    DiskCacheHeader existing;
+    bool compatible = false;
+    struct stat info;
+    if (fstat(cache->fd, &info) == 0 && (uint64_t)info.st_size == fileSize &&
+        pread(cache->fd, &existing, sizeof(existing), 0) == (ssize_t)sizeof(existing)) {
+        compatible = header_matches(&existing, entryCount, tileSize, chunkSize, format, imageBytes);
+    }
+    if (!compatible && (ftruncate(cache->fd, 0) != 0 || ftruncate(cache->fd, (off_t)fileSize) != 0)) {
+        close_cache(cache);
+        return NULL;
+    }
+    
+    void* base = mmap(NULL, (size_t)fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, cache->fd, 0);
+    if (base == MAP_FAILED) {
+        close_cache(cache);
+        return NULL;
+    }
+    cache->base = (unsigned char*)base;
+    cache->size = (size_t)fileSize;
+    cache->header = (DiskCacheHeader*)cache->base;
+    cache->entries = (DiskCacheEntry*)(cache->base + sizeof(DiskCacheHeader));
+    cache->format = format;
+    
+    if (!compatible) {
+        // The truncated file reads as zeros, so every record starts invalid
+        memcpy(cache->header->magic, DISK_CACHE_MAGIC, sizeof(cache->header->magic));
+        cache->header->version = DISK_CACHE_VERSION;
+        cache->header->entryCount = entryCount;
+        cache->header->tileSize = tileSize;
+        cache->header->chunkSize = chunkSize;
+        cache->header->format = (uint32_t)format;
+        cache->header->imageBytes = imageBytes;
+        cache->header->imageOffset = image_offset(entryCount);
+    }
+    return cache;
+}
+
+// False after an atlas invalidation until a key for the new atlas is set
+static bool cache_keyed(ChunkRenderSystem* system) {
+    return system->diskCache->keyVersion == system->atlasVersion;
+}
+
+static bool entry_current(ChunkRenderSystem* system, const DiskCacheEntry* entry, uint64_t contentHash) {
+    return entry->contentHash == contentHash && entry->atlasKey == system->diskCache->atlasKey;
+}
+
+bool chunk_disk_cache_load(ChunkRenderSystem* system, ChunkRenderData* chunk, uint64_t contentHash) {
+    ChunkDiskCache* cache = system->diskCache;
+    if (!cache || !cache_keyed(system) || !chunk->renderTexture) return false;
+    if (cache->format == DISK_CACHE_PIXELS && !system->backend->write_render_texture) return false;
+    
+    DiskCacheEntry* entry = find_entry(cache, chunk->chunkX, chunk->chunkY);
+    if (!entry || !entry_current(system, entry, contentHash)) return false;
+    if (cache->format == DISK_CACHE_QUADS) {
+        chunk_upload_tile_quads(system, chunk, (const ChunkTileQuad*)entry_image(cache, entry), entry->quadCount);
+        return true;
+    }
+    return system->backend->write_render_texture(system->backendContext, chunk->renderTexture,
+                                                 entry_image(cache, entry));
+}
+
+// Hash a clean chunk if needed; false when it is not stored or already current
+// Quads are built from the tilemap when written, so any loaded chunk is
+// queued and the check happens then
+static bool needs_store(ChunkRenderSystem* system, ChunkSlot* slot) {
+    ChunkDiskCache* cache = system->diskCache;
+    ChunkRenderData* chunk = &slot->data;
+    if (!cache || !cache_keyed(system) || !chunk->isLoaded) return false;
+    if (cache->format == DISK_CACHE_QUADS) return true;
+    if (!chunk->renderTexture || chunk->isDirty || slot->hasDirtyRegion || !system->backend->read_render_texture) {
+        return false;
+    }
+    
+    // Patched or prefetched chunks were not hashed while rebuilding
+    if (!slot->hasContentHash) {
+        ChunkTileRegion region = {0, 0, system->chunkSize, system->chunkSize};
+        chunk_gather_tile_ids(system, chunk->chunkX, chunk->chunkY, &region, system->tileIds);
+        slot->contentHash = chunk_tile_hash(system->tileIds, (size_t)system->chunkSize * (size_t)system->chunkSize);
+        slot->hasContentHash = true;
+    }
+    
+    DiskCacheEntry* entry = find_entry(cache, chunk->chunkX, chunk->chunkY);
+    return !entry || !entry_current(system, entry, slot->contentHash);
+}
+
+static DiskCacheEntry* store_entry(ChunkDiskCache* cache, int chunkX, int chunkY) {
+    DiskCacheEntry* entry = find_entry(cache, chunkX, chunkY);
+    if (!entry) {
+        entry = claim_entry(cache, chunkX, chunkY);
+    }
+    // Invalid until the record is complete, so a crash leaves no torn entry
+    entry->valid = 0;
+    return entry;
+}
+
+static void commit_entry(ChunkRenderSystem* system, DiskCacheEntry* entry, int chunkX, int chunkY,
+                         uint64_t contentHash) {
+    entry->chunkX = chunkX;
+    entry->chunkY = chunkY;
+    entry->atlasKey = system->diskCache->atlasKey;
+    entry->contentHash = contentHash;
+    entry->valid = 1;
+    CHUNK_STAT_ADD(system, diskCacheStores, 1);
+}
+
+// Gather and build the chunk's quads again; skipped when already current
+static void write_quads(ChunkRenderSystem* system, const DiskCacheStore* store) {
+    ChunkDiskCache* cache = system->diskCache;
+    ChunkTileRegion region = {0, 0, system->chunkSize, system->chunkSize};
+    chunk_gather_tile_ids(system, store->chunkX, store->chunkY, &region, system->tileIds);
+    uint64_t contentHash = chunk_tile_hash(system->tileIds, (size_t)system->chunkSize * (size_t)system->chunkSize);
+    
+    DiskCacheEntry* entry = find_entry(cache, store->chunkX, store->chunkY);
+    if (entry && entry_current(system, entry, contentHash)) return;
+    
+    entry = store_entry(cache, store->chunkX, store->chunkY);
+    size_t count = chunk_build_tile_quads(system, system->tileIds, &region, system->tileQuads, false);
+    memcpy(entry_image(cache, entry), system->tileQuads, sizeof(ChunkTileQuad) * count);
+    entry->quadCount = (uint32_t)count;
+    commit_entry(system, entry, store->chunkX, store->chunkY, contentHash);
+}
+
+static void write_image(ChunkRenderSystem* system, const DiskCacheStore* store) {
+    // Chunks drawn with an atlas the current key does not describe are dropped
+    ChunkDiskCache* cache = system->diskCache;
+    if (store->atlasVersion != cache->keyVersion) return;
+    if (cache->format == DISK_CACHE_QUADS) {
+        write_quads(system, store);
+        return;
+    }
+    
+    DiskCacheEntry* entry = store_entry(cache, store->chunkX, store->chunkY);
+    if (!system->backend->read_render_texture(system->backendContext, store->renderTexture,
+                                              entry_image(cache, entry))) {
+        return;
+    }
+    commit_entry(system, entry, store->chunkX, store->chunkY, store->contentHash);
+}
+
+static DiskCacheStore slot_store(ChunkRenderSystem* system, ChunkSlot* slot) {
+    DiskCacheStore store = {
+        system->diskCache->format == DISK_CACHE_PIXELS ? slot->data.renderTexture : NULL, false,
+        slot->data.chunkX, slot->data.chunkY, slot->contentHash, system->atlasVersion, false
+    };
+    return store;
+}
+
+void chunk_disk_cache_store(ChunkRenderSystem* system, ChunkSlot* slot) {
+    if (!needs_store(system, slot)) return;
+    
+    DiskCacheStore store = slot_store(system, slot);
+    write_image(system, &store);
+}
+
+void chunk_disk_cache_queue(ChunkRenderSystem* system, ChunkSlot* slot) {
+    if (!needs_store(system, slot)) return;
+    
+    // A full queue writes its oldest image now rather than growing
+    ChunkDiskCache* cache = system->diskCache;
+    if (cache->pendingCount == DISK_CACHE_QUEUE) {
+        chunk_disk_cache_drain(system);
+    }
+    cache->pending[(cache->pendingHead + cache->pendingCount) % DISK_CACHE_QUEUE] = slot_store(system, slot);
+    cache->pendingCount++;
+}
+
+bool chunk_disk_cache_drain(ChunkRenderSystem* system) {
+    ChunkDiskCache* cache = system->diskCache;
+    if (!cache || cache->pendingCount == 0) return false;
+    
+    DiskCacheStore store = cache->pending[cache->pendingHead];
+    cache->pendingHead = (cache->pendingHead + 1) % DISK_CACHE_QUEUE;
+    cache->pendingCount--;
+    if (store.written) return true;
+    
+    write_image(system, &store);
+    if (store.owned) {
+        chunk_render_target_release(system, store.renderTexture);
+    }
+    return true;
+}
+
+bool chunk_disk_cache_adopt(ChunkRenderSystem* system, void* renderTexture) {
+    ChunkDiskCache* cache = system->diskCache;
+    if (!cache || !renderTexture) return false;
+    
+    for (size_t i = 0; i < cache->pendingCount; i++) {
+        DiskCacheStore* store = &cache->pending[(cache->pendingHead + i) % DISK_CACHE_QUEUE];
+        if (store->renderTexture == renderTexture && !store->owned && !store->written) {
+            store->owned = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+void chunk_disk_cache_settle(ChunkRenderSystem* system, void* renderTexture) {
+    ChunkDiskCache* cache = system->diskCache;
+    if (!cache || !renderTexture) return;
+    
+    // Only borrowed textures are still in use, so nothing is released here
+    for (size_t i = 0; i < cache->pendingCount; i++) {
+        DiskCacheStore* store = &cache->pending[(cache->pendingHead + i) % DISK_CACHE_QUEUE];
+        if (store->renderTexture == renderTexture && !store->written) {
+            write_image(system, store);
+            store->written = true;
+        }
+    }
+}
+
+size_t chunk_disk_cache_pending_bytes(ChunkRenderSystem* system) {
+    ChunkDiskCache* cache = system->diskCache;
+    if (!cache) return 0;
+    
+    size_t owned = 0;
+    for (size_t i = 0; i < cache->pendingCount; i++) {
+        if (cache->pending[(cache->pendingHead + i) % DISK_CACHE_QUEUE].owned) owned++;
+    }
+    return owned * chunk_texture_bytes(system);
+}
+
+bool ChunkRenderSystem_enable_disk_cache(ChunkRenderSystem* system, const char* path,
+                                         size_t maxEntries, uint64_t atlasKey) {
+    if (!system || !path || maxEntries == 0 || maxEntries > UINT32_MAX) return false;
+    
+    // Without pixel access the built quads are kept, which still skips the
+    // atlas lookups and quad building on a hit
+    bool pixels = system->backend->read_render_texture && system->backend->write_render_texture;
+    DiskCacheFormat format = pixels ? DISK_CACHE_PIXELS : DISK_CACHE_QUADS;
+    uint64_t imageBytes = pixels ? chunk_texture_bytes(system)
+                                 : sizeof(ChunkTileQuad) * (size_t)system->chunkSize * (size_t)system->chunkSize;
+    
+    ChunkRenderSystem_disable_disk_cache(system);
+    ChunkDiskCache* cache = open_cache(path, (uint32_t)maxEntries, system->tileSize, system->chunkSize,
+                                       format, imageBytes);
+    if (!cache) return false;
+    
+    cache->atlasKey = atlasKey;
+    cache->keyVersion = system->atlasVersion;
+    system->diskCache = cache;
+    return true;
+}
+
+void ChunkRenderSystem_set_disk_cache_atlas_key(ChunkRenderSystem* system, uint64_t atlasKey) {
+    if (!system || !system->diskCache) return;
+    
+    system->diskCache->atlasKey = atlasKey;
+    system->diskCache->keyVersion = system->atlasVersion;
+}
+
+void ChunkRenderSystem_flush_disk_cache(ChunkRenderSystem* system) {
+    if (!system || !system->diskCache) return;
+    
+    while (chunk_disk_cache_drain(system)) {
+    }
+    for (ChunkSlot* slot = system->residentHead; slot; slot = slot->next) {
+        chunk_disk_cache_store(system, slot);
+    }
+    msync(system->diskCache->base, system->diskCache->size, MS_ASYNC);
+}
+
+void ChunkRenderSystem_disable_disk_cache(ChunkRenderSystem* system) {
+    if (!system || !system->diskCache) return;
+    
+    ChunkRenderSystem_flush_disk_cache(system);
+    close_cache(system->diskCache);
+    system->diskCache = NULL;
+}
+
+#else
+
+bool chunk_disk_cache_load(ChunkRenderSystem* system, ChunkRenderData* chunk, uint64_t contentHash) {
+    (void)system; (void)chunk; (void)contentHash;
+    return false;
+}
+
+void chunk_disk_cache_store(ChunkRenderSystem* system, ChunkSlot* slot) {
+    (void)system; (void)slot;
+}
+
+void chunk_disk_cache_queue(ChunkRenderSystem* system, ChunkSlot* slot) {
+    (void)system; (void)slot;
+}
+
+bool chunk_disk_cache_drain(ChunkRenderSystem* system) {
+    (void)system;
+    return false;
+}
+
+bool chunk_disk_cache_adopt(ChunkRenderSystem* system, void* renderTexture) {
+    (void)system; (void)renderTexture;
+    return false;
+}
+
+void chunk_disk_cache_settle(ChunkRenderSystem* system, void* renderTexture) {
+    (void)system; (void)renderTexture;
+}
+
+size_t chunk_disk_cache_pending_bytes(ChunkRenderSystem* system) {
+    (void)system;
+    return 0;
+}
+
+bool ChunkRenderSystem_enable_disk_cache(ChunkRenderSystem* system, const char* path,
+                                         size_t maxEntries, uint64_t atlasKey) {
+    (void)system; (void)path; (void)maxEntries; (void)atlasKey;
+    return false;
+}
+
+void ChunkRenderSystem_set_disk_cache_atlas_key(ChunkRenderSystem* system, uint64_t atlasKey) {
+    (void)system; (void)atlasKey;
+}
+
+void ChunkRenderSystem_flush_disk_cache(ChunkRenderSystem* system) {
+    (void)system;
+}
+
+void ChunkRenderSystem_disable_disk_cache(ChunkRenderSystem* system) {
+    (void)system;
+}
+
+#endif
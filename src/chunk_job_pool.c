@@ -0,0 +1,230 @@
+#include "chunk_render_internal.h"
+#include "chunk_thread.h"
+#include <stdlib.h>
+
+#if CHUNK_RENDER_HAS_THREADS
+
+// Contiguous run of job indices; the owner takes from the front,
+// idle threads steal from the back
+typedef struct ChunkJobQueue {
+    ChunkMutex mutex;
+    int begin;
+    int end;
+} ChunkJobQueue;
+
+typedef struct ChunkJobWorker {
+    ChunkJobPool* pool;
+    int queueIndex;
+} ChunkJobWorker;
+
+struct ChunkJobPool {
+    int threadCount;             // Including the calling thread
+    ChunkThread* threads;        // threadCount - 1 workers
+    ChunkJobWorker* workers;
+    ChunkJobQueue* queues;       // One per thread, queue 0 belongs to the caller
+    
+    ChunkMutex mutex;            // Guards everything below
+    ChunkCond wake;
+    ChunkCond done;
+    uint64_t generation;         // Bumped for every run
+    ChunkRenderJobFn job;
+    void* context;
+    int remaining;               // Jobs of the current run not yet finished
+    int busy;                    // Workers currently draining the current run
+    bool quit;
+};
+
+static bool take_job(ChunkJobQueue* queue, bool fromBack, int* outIndex) {
+    bool found = false;
+    ChunkMutex_lock(&queue->mutex);
+    if (queue->begin < queue->end) {
+        *outIndex = fromBack ? --queue->end : queue->begin++;
+        found = true;
+    }
+    ChunkMutex_unlock(&queue->mutex);
+    return found;
+}
+
+// Run jobs from our own queue, then steal until every queue is empty
+static int drain(ChunkJobPool* pool, int self, ChunkRenderJobFn job, void* context) {
+    int completed = 0;
+    int index;
+    for (;;) {
+        if (take_job(&pool->queues[self], false, &index)) {
+            job(context, index);
+            completed++;
+            continue;
+        }
+        
+        bool stole = false;
+        for (int i = 1; i < pool->threadCount && !stole; i++) {
+            int victim = (self + i) % pool->threadCount;
+            if (take_job(&pool->queues[victim], true, &index)) {
+                job(context, index);
+                completed++;
+                stole = true;
+            }
+        }
+        if (!stole) return completed;
+    }
+}
+
+static void finish_jobs(ChunkJobPool* pool, int completed) {
+    pool->remaining -= completed;
+    if (pool->remaining == 0 && pool->busy == 0) {
+        ChunkCond_broadcast(&pool->done);
+    }
+}
+
+static void worker_main(void* arg) {
+    ChunkJobWorker* worker = (ChunkJobWorker*)arg;
+    ChunkJobPool* pool = worker->pool;
+    uint64_t seen = 0;
+    
+    ChunkMutex_lock(&pool->mutex);
+    while (!pool->quit) {
+        if (pool->generation == seen) {
+            ChunkCond_wait(&pool->wake, &pool->mutex);
+            continue;
+        }
+        
+        seen = pool->generation;
+        ChunkRenderJobFn job = pool->job;
+        void* context = pool->context;
+        pool->busy++;
+        ChunkMutex_unlock(&pool->mutex);
+        
+        int completed = drain(pool, worker->queueIndex, job, context);
+        
+        ChunkMutex_lock(&pool->mutex);
+        pool->busy--;
+        finish_jobs(pool, completed);
+    }
+    ChunkMutex_unlock(&pool->mutex);
+}
+
+void chunk_job_pool_run(int jobCount, ChunkRenderJobFn job, void* context, void* userData) {
+    ChunkJobPool* pool = (ChunkJobPool*)userData;
+    if (jobCount <= 0) return;
+    
+    ChunkMutex_lock(&pool->mutex);
+    
+    // A worker that woke after the previous run finished may still be
+    // holding that run's job; the queues are only refilled once it is done
+    while (pool->busy > 0) {
+        ChunkCond_wait(&pool->done, &pool->mutex);
+    }
+    
+    // Split the indices into equal contiguous runs, one per thread
+    for (int i = 0; i < pool->threadCount; i++) {
+        ChunkJobQueue* queue = &pool->queues[i];
+        ChunkMutex_lock(&queue->mutex);
+        queue->begin = (int)((long)jobCount * i / pool->threadCount);
+        queue->end = (int)((long)jobCount * (i + 1) / pool->threadCount);
+        ChunkMutex_unlock(&queue->mutex);
+    }
+    
+    pool->job = job;
+    pool->context = context;
+    pool->remaining = jobCount;
+    pool->generation++;
+    ChunkCond_broadcast(&pool->wake);
+    ChunkMutex_unlock(&pool->mutex);
+    
+    int completed = drain(pool, 0, job, context);
+    
+    ChunkMutex_lock(&pool->mutex);
+    finish_jobs(pool, completed);
+    while (pool->remaining > 0 || pool->busy > 0) {
+        ChunkCond_wait(&pool->done, &pool->mutex);
+    }
+    ChunkMutex_unlock(&pool->mutex);
+}
+
+ChunkJobPool* chunk_job_pool_create(int threadCount) {
+    if (threadCount < 2) return NULL;
+    
+    ChunkJobPool* pool = (ChunkJobPool*)calloc(1, sizeof(ChunkJobPool));
+    if (!pool) return NULL;
+    pool->threads = (ChunkThread*)calloc((size_t)threadCount - 1, sizeof(ChunkThread));
+    pool->workers = (ChunkJobWorker*)calloc((size_t)threadCount - 1, sizeof(ChunkJobWorker));
+    pool->queues = (ChunkJobQueue*)calloc((size_t)threadCount, sizeof(ChunkJobQueue));
+    if (!pool->threads || !pool->workers || !pool->queues) {
+        free(pool->threads);
+        free(pool->workers);
+        free(pool->queues);
+        free(pool);
+        return NULL;
+    }
+    
+    ChunkMutex_init(&pool->mutex);
+    ChunkCond_init(&pool->wake);
+    ChunkCond_init(&pool->done);
+    for (int i = 0; i < threadCount; i++) {
+        ChunkMutex_init(&pool->queues[i].mutex);
+    }
+    
+    // The calling thread is thread 0, so a pool that failed to start
+    // some workers still works with fewer threads
+    pool->threadCount = 1;
+    for (int i = 0; i < threadCount - 1; i++) {
+        pool->workers[i].pool = pool;
+        pool->workers[i].queueIndex = i + 1;
+        if (!ChunkThread_start(&pool->threads[i], worker_main, &pool->workers[i])) break;
+        pool->threadCount++;
+    }
+    return pool;
+}
+
+void chunk_job_pool_destroy(ChunkJobPool* pool) {
+    if (!pool) return;
+    
+    ChunkMutex_lock(&pool->mutex);
+    pool->quit = true;
+    ChunkCond_broadcast(&pool->wake);
+    ChunkMutex_unlock(&pool->mutex);
+    for (int i = 0; i < pool->threadCount - 1; i++) {
+        ChunkThread_join(pool->threads[i]);
+    }
+    
+    for (int i = 0; i < pool->threadCount; i++) {
+        ChunkMutex_destroy(&pool->queues[i].mutex);
+    }
+    ChunkCond_destroy(&pool->done);
+    ChunkCond_destroy(&pool->wake);
+    ChunkMutex_destroy(&pool->mutex);
+    free(pool->threads);
+    free(pool->workers);
+    free(pool->queues);
+    free(pool);
+}
+
+int chunk_job_pool_thread_count(ChunkJobPool* pool) {
+    return pool ? pool->threadCount : 1;
+}
+
+#else
+
+// No threads on this platform: the render system keeps building on the caller
+void chunk_job_pool_run(int jobCount, ChunkRenderJobFn job, void* context, void* userData) {
+    (void)userData;
+    for (int i = 0; i < jobCount; i++) {
+        job(context, i);
+    }
+}
+
+ChunkJobPool* chunk_job_pool_create(int threadCount) {
+    (void)threadCount;
+    return NULL;
+}
+
+void chunk_job_pool_destroy(ChunkJobPool* pool) {
+    (void)pool;
+}
+
+int chunk_job_pool_thread_count(ChunkJobPool* pool) {
+    (void)pool;
+    return 1;
+}
+
+#endif
@@ -0,0 +1,230 @@
+#include "chunk_render_internal.h"
+
+#define FULL_RES_RELEASE_FRAMES 60  // Frames a chunk goes undrawn at level 0 before its target is released
+
+static RenderColor color_white(void) {
+    RenderColor c = {255, 255, 255, 255};
+    return c;
+}
+
+// Effective scale at which a level maps one texel to one screen pixel
+static float lod_threshold(int level) {
+    return 1.0f / (float)(1 << level);
+}
+
+static int lod_pixel_size(ChunkRenderSystem* system, int level) {
+    return (system->chunkSize * system->tileSize) >> level;
+}
+
+int chunk_lod_select(ChunkRenderSystem* system, int current, float effectiveScale) {
+    if (system->lodMaxLevel <= 0 || effectiveScale <= 0.0f) {
+        return 0;
+    }
+    if (current > system->lodMaxLevel) {
+        current = system->lodMaxLevel;
+    }
+    
+    int target = 0;
+    while (target < system->lodMaxLevel && effectiveScale <= lod_threshold(target + 1)) {
+        target++;
+    }
+    
+    // Only leave the current level once the scale is clearly past the threshold
+    float h = system->lodHysteresis;
+    while (target > current && effectiveScale > lod_threshold(target) * (1.0f - h)) {
+        target--;
+    }
+    while (target < current && effectiveScale <= lod_threshold(target + 1) * (1.0f + h)) {
+        target++;
+    }
+    return target;
+}
+
+// Finest texture below a level to downsample from: the full-resolution one,
+// or for an LOD-only chunk its finest valid LOD level (-1 if there is none)
+static int source_level(ChunkSlot* slot, int level) {
+    if (slot->data.renderTexture) return 0;
+    for (int finer = 1; finer < level; finer++) {
+        if (slot->lodValid & (1u << (finer - 1))) return finer;
+    }
+    return -1;
+}
+
+static void build_lod(ChunkRenderSystem* system, ChunkSlot* slot, int level) {
+    int index = level - 1;
+    int size = lod_pixel_size(system, level);
+    int sourceLevel = source_level(slot, level);
+    if (sourceLevel < 0) return;
+    
+    if (!slot->lodTextures[index]) {
+        slot->lodTextures[index] = system->backend->create_render_texture(system->backendContext, size, size);
+        if (!slot->lodTextures[index]) return;
+        system->lodTextureBytes += (size_t)size * (size_t)size * 4;
+    }
+    
+    void* sourceTexture = sourceLevel > 0 ? slot->lodTextures[sourceLevel - 1] : slot->data.renderTexture;
+    void* source = system->backend->get_render_texture_texture(system->backendContext, sourceTexture);
+    if (!source) return;
+    
+    // Downsample the source texture in one draw
+    float sourceSize = (float)lod_pixel_size(system, sourceLevel);
+    RenderCommand downsampleCmd = {
+        .type = RENDER_COMMAND_TYPE_TEXTURE_PRO,
+        .bounds = {0, 0, (float)size, (float)size},
+        .color = color_white(),
+        .data.texture = {
+            .textureHandle = source,
+            .srcRect = {0, 0, sourceSize, -sourceSize},
+            .rotation = 0.0f,
+            .origin = {0, 0}
+        }
+    };
+    system->backend->begin_render_texture(system->backendContext, slot->lodTextures[index]);
+    system->backend->execute_command(system->backendContext, &downsampleCmd);
+    system->backend->end_render_texture(system->backendContext);
+    CHUNK_STAT_ADD(system, drawCommands, 1);
+    
+    slot->lodValid |= 1u << index;
+}
+
+// Bit per level (level - 1) drawn by the default view or any viewport
+static unsigned levels_in_use(ChunkRenderSystem* system) {
+    unsigned levels = 0;
+    if (system->lodLevel > 0) {
+        levels |= 1u << (system->lodLevel - 1);
+    }
+    for (int i = 0; i < CHUNK_RENDER_MAX_VIEWPORTS; i++) {
+        const ChunkRenderViewport* view = &system->viewports[i];
+        if (view->active && view->lodLevel > 0) {
+            levels |= 1u << (view->lodLevel - 1);
+        }
+    }
+    return levels;
+}
+
+static bool full_res_in_use(ChunkRenderSystem* system) {
+    if (system->lodLevel == 0) return true;
+    for (int i = 0; i < CHUNK_RENDER_MAX_VIEWPORTS; i++) {
+        if (system->viewports[i].active && system->viewports[i].lodLevel == 0) return true;
+    }
+    return false;
+}
+
+bool chunk_lod_needs_full(ChunkRenderSystem* system, ChunkSlot* slot) {
+    // LOD levels are downsampled from the chunk's own target
+    if (slot->pageOnly) return levels_in_use(system) != 0;
+    if (!slot->lodOnly) return false;
+    if (full_res_in_use(system)) return true;
+    
+    unsigned missing = levels_in_use(system) & ~slot->lodValid;
+    for (int level = 1; missing; level++, missing >>= 1) {
+        if ((missing & 1u) && source_level(slot, level) < 0) return true;
+    }
+    return false;
+}
+
+// Give the full-resolution target back once every level in use is built and
+// no view has drawn level 0 for a while; mirrors eviction, minus the LODs
+static void release_full_res(ChunkRenderSystem* system, ChunkSlot* slot) {
+    chunk_disk_cache_queue(system, slot);
+    if (!chunk_dedup_release(system, slot)) {
+        chunk_render_target_release(system, slot->data.renderTexture);
+    }
+    slot->data.renderTexture = NULL;
+    chunk_page_release(system, slot);
+    slot->lodOnly = true;
+    system->lodOnlyChunks++;
+}
+
+void chunk_lod_update(ChunkRenderSystem* system) {
+    unsigned levels = levels_in_use(system);
+    if (!levels || !system->backendContext) return;
+    
+    bool releaseFullRes = !full_res_in_use(system);
+    int built = 0;
+    for (size_t i = 0; i < system->coverageSpanCount; i++) {
+        const ChunkSpan* span = &system->coverageSpans[i];
+        for (int chunkX = span->minChunkX; chunkX <= span->maxChunkX; chunkX++) {
+            if (system->maxRebuildsPerFrame > 0 && built >= system->maxRebuildsPerFrame) return;
+            
+            IntCoord coord = {chunkX, span->chunkY};
+            ChunkSlot* slot = (ChunkSlot*)Table_get(system->chunks, &coord);
+            if (!slot || !slot->data.isLoaded || slot->data.isDirty || slot->hasDirtyRegion) continue;
+            
+            unsigned missing = levels & ~slot->lodValid;
+            for (int level = 1; missing; level++, missing >>= 1) {
+                if (!(missing & 1u)) continue;
+                if (system->maxRebuildsPerFrame > 0 && built >= system->maxRebuildsPerFrame) return;
+                build_lod(system, slot, level);
+                built++;
+            }
+            
+            if (releaseFullRes && slot->data.renderTexture && (levels & ~slot->lodValid) == 0 &&
+                system->currentFrame - slot->fullResFrame >= FULL_RES_RELEASE_FRAMES) {
+                release_full_res(system, slot);
+            }
+        }
+    }
+}
+
+void* chunk_lod_texture(ChunkRenderSystem* system, ChunkSlot* slot, int level, float* outPixelSize) {
+    if (level > 0 && (slot->lodValid & (1u << (level - 1)))) {
+        *outPixelSize = (float)lod_pixel_size(system, level);
+        return system->backend->get_render_texture_texture(system->backendContext, slot->lodTextures[level - 1]);
+    }
+    if (slot->data.renderTexture) {
+        slot->fullResFrame = system->currentFrame;
+        *outPixelSize = (float)(system->chunkSize * system->tileSize);
+        return system->backend->get_render_texture_texture(system->backendContext, slot->data.renderTexture);
+    }
+    
+    // LOD-only chunk waiting to be redrawn: stretch its finest image
+    for (int finer = 1; finer <= CHUNK_RENDER_MAX_LOD_LEVEL; finer++) {
+        if (slot->lodValid & (1u << (finer - 1))) {
+            *outPixelSize = (float)lod_pixel_size(system, finer);
+            return system->backend->get_render_texture_texture(system->backendContext, slot->lodTextures[finer - 1]);
+        }
+    }
+    return NULL;
+}
+
+void chunk_lod_release(ChunkRenderSystem* system, ChunkSlot* slot) {
+    for (int level = 1; level <= CHUNK_RENDER_MAX_LOD_LEVEL; level++) {
+        void* texture = slot->lodTextures[level - 1];
+        if (!texture) continue;
+        
+        if (system->backendContext) {
+            system->backend->destroy_render_texture(system->backendContext, texture);
+        }
+        int size = lod_pixel_size(system, level);
+        system->lodTextureBytes -= (size_t)size * (size_t)size * 4;
+        slot->lodTextures[level - 1] = NULL;
+    }
+    slot->lodValid = 0;
+}
+
+void ChunkRenderSystem_set_lod(ChunkRenderSystem* system, int maxLevel, float hysteresis) {
+    if (!system) return;
+    if (maxLevel < 0) maxLevel = 0;
+    if (maxLevel > CHUNK_RENDER_MAX_LOD_LEVEL) maxLevel = CHUNK_RENDER_MAX_LOD_LEVEL;
+    
+    // Half/quarter textures must still hold at least one pixel
+    while (maxLevel > 0 && lod_pixel_size(system, maxLevel) < 1) {
+        maxLevel--;
+    }
+    system->lodMaxLevel = maxLevel;
+    system->lodHysteresis = hysteresis < 0.0f ? 0.0f : hysteresis;
+    if (system->lodLevel > maxLevel) {
+        system->lodLevel = maxLevel;
+    }
+    for (int i = 0; i < CHUNK_RENDER_MAX_VIEWPORTS; i++) {
+        if (system->viewports[i].lodLevel > maxLevel) {
+            system->viewports[i].lodLevel = maxLevel;
+        }
+    }
+}
+
+int ChunkRenderSystem_get_lod_level(ChunkRenderSystem* system) {
+    if (!system) return 0;
+    return system->lodLevel;
+}
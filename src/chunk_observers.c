@@ -0,0 +1,579 @@
+#include "chunk_render_internal.h"
+#include "core/position.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Observer storage
+// Observers live in dense arrays (entity observers first, so polling
+// positions only walks [0, entityObserverCount)). Handles name a stable
+// record that points at the dense index, and an open-addressing table maps
+// observer keys (entity id or manual tile) to records for O(1) add/remove.
+// Each record is also linked into the bucket of the chunk it stands in, so
+// coverage only changes when a chunk gains its first or loses its last observer.
+
+#define OBSERVER_NONE UINT32_MAX
+
+struct ChunkObserverRecord {
+    uint32_t index;              // Dense index while live, next free record + 1 otherwise
+    uint32_t generation;         // Bumped on removal so stale handles miss
+    uint32_t prevInChunk;        // Bucket list links (record ids)
+    uint32_t nextInChunk;
+    bool live;
+};
+
+struct ChunkObserverBucket {
+    IntCoord chunk;
+    uint32_t count;              // 0 = empty table slot
+    uint32_t head;               // First record in this chunk
+    uint64_t edgeFrame;          // Frame edgeHeadings was last written
+    uint16_t edgeHeadings;       // Bit per heading whose prefetch edge was scanned
+};
+
+static uint32_t mix_hash(uint64_t value) {
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    return (uint32_t)value;
+}
+
+static uint32_t observer_hash(const Observer* observer) {
+    if (observer->type == OBSERVER_ENTITY) {
+        return mix_hash(observer->data.entityId.high * 0x9e3779b97f4a7c15ULL ^ observer->data.entityId.low);
+    }
+    uint64_t packed = ((uint64_t)(uint32_t)observer->data.manual.tileX << 32) | (uint32_t)observer->data.manual.tileY;
+    return mix_hash(packed ^ 0x5bd1e995ULL);
+}
+
+static bool observer_equal(const Observer* a, const Observer* b) {
+    if (a->type != b->type) return false;
+    if (a->type == OBSERVER_ENTITY) {
+        return a->data.entityId.high == b->data.entityId.high && a->data.entityId.low == b->data.entityId.low;
+    }
+    return a->data.manual.tileX == b->data.manual.tileX && a->data.manual.tileY == b->data.manual.tileY;
+}
+
+static uint32_t chunk_hash(IntCoord chunk) {
+    return mix_hash(((uint64_t)(uint32_t)chunk.x << 32) | (uint32_t)chunk.y);
+}
+
+static ChunkObserverHandle make_handle(ChunkRenderSystem* system, uint32_t record) {
+    return ((ChunkObserverHandle)system->observerRecords[record].generation << 32) | (ChunkObserverHandle)(record + 1);
+}
+
+// Record id for a live handle, OBSERVER_NONE if it is stale or invalid
+static uint32_t handle_record(ChunkRenderSystem* system, ChunkObserverHandle handle) {
+    uint64_t low = handle & 0xffffffffULL;
+    if (low == 0 || low > system->observerRecordCount) return OBSERVER_NONE;
+    uint32_t record = (uint32_t)(low - 1);
+    ChunkObserverRecord* entry = &system->observerRecords[record];
+    if (!entry->live || entry->generation != (uint32_t)(handle >> 32)) return OBSERVER_NONE;
+    return record;
+}
+
+static const Observer* record_observer(ChunkRenderSystem* system, uint32_t record) {
+    return &system->observers[system->observerRecords[record].index];
+}
+
+// --- Key table (record id + 1 per slot, 0 = empty) ---
+
+static size_t key_find_slot(ChunkRenderSystem* system, const Observer* key, bool* found) {
+    size_t mask = system->observerKeyCapacity - 1;
+    size_t slot = observer_hash(key) & mask;
+    while (system->observerKeys[slot]) {
+        if (observer_equal(record_observer(system, system->observerKeys[slot] - 1), key)) {
+            *found = true;
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+    *found = false;
+    return slot;
+}
+
+static uint32_t key_lookup(ChunkRenderSystem* system, const Observer* key) {
+    if (system->observerKeyCapacity == 0) return OBSERVER_NONE;
+    bool found;
+    size_t slot = key_find_slot(system, key, &found);
+    return found ? system->observerKeys[slot] - 1 : OBSERVER_NONE;
+}
+
+static bool key_reserve(ChunkRenderSystem* system, size_t count) {
+    if (count * 2 <= system->observerKeyCapacity) return true;
+    
+    size_t newCapacity = system->observerKeyCapacity ? system->observerKeyCapacity * 2 : 64;
+    while (count * 2 > newCapacity) {
+        newCapacity *= 2;
+    }
+    uint32_t* keys = (uint32_t*)calloc(newCapacity, sizeof(uint32_t));
+    if (!keys) return false;
+    
+    uint32_t* oldKeys = system->observerKeys;
+    size_t oldCapacity = system->observerKeyCapacity;
+    system->observerKeys = keys;
+    system->observerKeyCapacity = newCapacity;
+    for (size_t i = 0; i < oldCapacity; i++) {
+        if (!oldKeys[i]) continue;
+        bool found;
+        size_t slot = key_find_slot(system, record_observer(system, oldKeys[i] - 1), &found);
+        keys[slot] = oldKeys[i];
+    }
+    free(oldKeys);
+    return true;
+}
+
+static void key_insert(ChunkRenderSystem* system, uint32_t record) {
+    bool found;
+    size_t slot = key_find_slot(system, record_observer(system, record), &found);
+    system->observerKeys[slot] = record + 1;
+}
+
+// Backward-shift deletion keeps probe chains intact without tombstones
+static void key_remove(ChunkRenderSystem* system, uint32_t record) {
+    bool found;
+    size_t hole = key_find_slot(system, record_observer(system, record), &found);
+    if (!found) return;
+    
+    size_t mask = system->observerKeyCapacity - 1;
+    size_t next = hole;
+    for (;;) {
+        next = (next + 1) & mask;
+        uint32_t entry = system->observerKeys[next];
+        if (!entry) break;
+        size_t home = observer_hash(record_observer(system, entry - 1)) & mask;
+        bool stays = hole <= next ? (hole < home && home <= next) : (hole < home || home <= next);
+        if (stays) continue;
+        system->observerKeys[hole] = entry;
+        hole = next;
+    }
+    system->observerKeys[hole] = 0;
+}
+
+// --- Chunk buckets ---
+
+static ChunkObserverBucket* bucket_find(ChunkRenderSystem* system, IntCoord chunk, bool* found) {
+    size_t mask = system->observerBucketCapacity - 1;
+    size_t slot = chunk_hash(chunk) & mask;
+    while (system->observerBuckets[slot].count) {
+        ChunkObserverBucket* bucket = &system->observerBuckets[slot];
+        if (bucket->chunk.x == chunk.x && bucket->chunk.y == chunk.y) {
+            *found = true;
+            return bucket;
+        }
+        slot = (slot + 1) & mask;
+    }
+    *found = false;
+    return &system->observerBuckets[slot];
+}
+
+static bool bucket_reserve(ChunkRenderSystem* system, size_t count) {
+    if (count * 2 <= system->observerBucketCapacity) return true;
+    
+    size_t newCapacity = system->observerBucketCapacity ? system->observerBucketCapacity * 2 : 64;
+    while (count * 2 > newCapacity) {
+        newCapacity *= 2;
+    }
+    ChunkObserverBucket* buckets = (ChunkObserverBucket*)calloc(newCapacity, sizeof(ChunkObserverBucket));
+    if (!buckets) return false;
+    
+    ChunkObserverBucket* oldBuckets = system->observerBuckets;
+    size_t oldCapacity = system->observerBucketCapacity;
+    system->observerBuckets = buckets;
+    system->observerBucketCapacity = newCapacity;
+    for (size_t i = 0; i < oldCapacity; i++) {
+        if (!oldBuckets[i].count) continue;
+        bool found;
+        *bucket_find(system, oldBuckets[i].chunk, &found) = oldBuckets[i];
+    }
+    free(oldBuckets);
+    return true;
+}
+
+static void bucket_link(ChunkRenderSystem* system, uint32_t record, IntCoord chunk) {
+    bool found;
+    ChunkObserverBucket* bucket = bucket_find(system, chunk, &found);
+    ChunkObserverRecord* entry = &system->observerRecords[record];
+    if (!found) {
+        bucket->chunk = chunk;
+        bucket->head = OBSERVER_NONE;
+        system->observerBucketCount++;
+        chunk_coverage_invalidate(system);
+    }
+    entry->prevInChunk = OBSERVER_NONE;
+    entry->nextInChunk = bucket->head;
+    if (bucket->head != OBSERVER_NONE) {
+        system->observerRecords[bucket->head].prevInChunk = record;
+    }
+    bucket->head = record;
+    bucket->count++;
+}
+
+static void bucket_unlink(ChunkRenderSystem* system, uint32_t record, IntCoord chunk) {
+    bool found;
+    ChunkObserverBucket* bucket = bucket_find(system, chunk, &found);
+    if (!found) return;
+    
+    ChunkObserverRecord* entry = &system->observerRecords[record];
+    if (entry->prevInChunk != OBSERVER_NONE) {
+        system->observerRecords[entry->prevInChunk].nextInChunk = entry->nextInChunk;
+    } else {
+        bucket->head = entry->nextInChunk;
+    }
+    if (entry->nextInChunk != OBSERVER_NONE) {
+        system->observerRecords[entry->nextInChunk].prevInChunk = entry->prevInChunk;
+    }
+    if (--bucket->count > 0) return;
+    
+    // Last observer left the chunk: backward-shift the bucket out
+    size_t mask = system->observerBucketCapacity - 1;
+    size_t hole = (size_t)(bucket - system->observerBuckets);
+    size_t next = hole;
+    for (;;) {
+        next = (next + 1) & mask;
+        ChunkObserverBucket* candidate = &system->observerBuckets[next];
+        if (!candidate->count) break;
+        size_t home = chunk_hash(candidate->chunk) & mask;
+        bool stays = hole <= next ? (hole < home && home <= next) : (hole < home || home <= next);
+        if (stays) continue;
+        system->observerBuckets[hole] = *candidate;
+        hole = next;
+    }
+    memset(&system->observerBuckets[hole], 0, sizeof(ChunkObserverBucket));
+    system->observerBucketCount--;
+    chunk_coverage_invalidate(system);
+}
+
+// --- Dense storage ---
+
+static bool dense_reserve(ChunkRenderSystem* system, size_t count) {
+    if (count <= system->observerCapacity) return true;
+    
+    size_t newCapacity = system->observerCapacity ? system->observerCapacity * 2 : 16;
+    while (newCapacity < count) {
+        newCapacity *= 2;
+    }
+    Observer* observers = (Observer*)realloc(system->observers, sizeof(Observer) * newCapacity);
+    if (observers) system->observers = observers;
+    IntCoord* chunks = (IntCoord*)realloc(system->observerChunks, sizeof(IntCoord) * newCapacity);
+    if (chunks) system->observerChunks = chunks;
+    IntCoord* headings = (IntCoord*)realloc(system->observerHeadings, sizeof(IntCoord) * newCapacity);
+    if (headings) system->observerHeadings = headings;
+    uint32_t* ids = (uint32_t*)realloc(system->observerIds, sizeof(uint32_t) * newCapacity);
+    if (ids) system->observerIds = ids;
+    if (!observers || !chunks || !headings || !ids) return false;
+    
+    system->observerCapacity = newCapacity;
+    return true;
+}
+
+static bool record_reserve(ChunkRenderSystem* system) {
+    if (system->observerFreeRecord != 0 ||
+        system->observerRecordCount < system->observerRecordCapacity) {
+        return true;
+    }
+    size_t newCapacity = system->observerRecordCapacity ? system->observerRecordCapacity * 2 : 16;
+    ChunkObserverRecord* records = (ChunkObserverRecord*)realloc(system->observerRecords,
+                                                                 sizeof(ChunkObserverRecord) * newCapacity);
+    if (!records) return false;
+    system->observerRecords = records;
+    system->observerRecordCapacity = newCapacity;
+    return true;
+}
+
+static uint32_t record_acquire(ChunkRenderSystem* system) {
+    uint32_t record;
+    if (system->observerFreeRecord != 0) {
+        record = system->observerFreeRecord - 1;
+        system->observerFreeRecord = system->observerRecords[record].index;
+    } else {
+        record = (uint32_t)system->observerRecordCount++;
+        system->observerRecords[record].generation = 1;
+    }
+    system->observerRecords[record].live = true;
+    return record;
+}
+
+static void move_dense(ChunkRenderSystem* system, size_t from, size_t to) {
+    if (from == to) return;
+    system->observers[to] = system->observers[from];
+    system->observerChunks[to] = system->observerChunks[from];
+    system->observerHeadings[to] = system->observerHeadings[from];
+    system->observerIds[to] = system->observerIds[from];
+    system->observerRecords[system->observerIds[to]].index = (uint32_t)to;
+}
+
+static void observer_tile_chunk(ChunkRenderSystem* system, const Observer* observer, ECS* ecs,
+                                ComponentTypeId positionTypeId, IntCoord* out) {
+    int tileX = 0, tileY = 0;
+    if (observer->type == OBSERVER_ENTITY) {
+        Position* pos = Position_get(ecs, observer->data.entityId, positionTypeId);
+        if (pos) {
+            tileX = pos->x;
+            tileY = pos->y;
+        }
+    } else {
+        tileX = observer->data.manual.tileX;
+        tileY = observer->data.manual.tileY;
+    }
+    ChunkRenderSystem_get_chunk_coord(system, tileX, tileY, &out->x, &out->y);
+}
+
+static ChunkObserverHandle add_observer(ChunkRenderSystem* system, const Observer* observer, IntCoord chunk) {
+    uint32_t existing = key_lookup(system, observer);
+    if (existing != OBSERVER_NONE) {
+        return make_handle(system, existing);
+    }
+    
+    size_t count = system->observerCount + 1;
+    if (!dense_reserve(system, count) || !record_reserve(system) ||
+        !key_reserve(system, count) || !bucket_reserve(system, system->observerBucketCount + 1)) {
+        return 0;
+    }
+    
+    // Entity observers stay in front: push the first manual observer back
+    size_t index = system->observerCount;
+    if (observer->type == OBSERVER_ENTITY) {
+        index = system->entityObserverCount++;
+        move_dense(system, index, system->observerCount);
+    }
+    system->observerCount++;
+    
+    uint32_t record = record_acquire(system);
+    system->observerRecords[record].index = (uint32_t)index;
+    system->observers[index] = *observer;
+    system->observerChunks[index] = chunk;
+    system->observerHeadings[index].x = 0;
+    system->observerHeadings[index].y = 0;
+    system->observerIds[index] = record;
+    key_insert(system, record);
+    bucket_link(system, record, chunk);
+    return make_handle(system, record);
+}
+
+static void remove_record(ChunkRenderSystem* system, uint32_t record) {
+    ChunkObserverRecord* entry = &system->observerRecords[record];
+    size_t index = entry->index;
+    key_remove(system, record);
+    bucket_unlink(system, record, system->observerChunks[index]);
+    
+    // Keep the entity partition contiguous, then swap-remove the tail
+    size_t hole = index;
+    if (index < system->entityObserverCount) {
+        hole = --system->entityObserverCount;
+        move_dense(system, hole, index);
+    }
+    move_dense(system, system->observerCount - 1, hole);
+    system->observerCount--;
+    
+    entry->live = false;
+    entry->generation++;
+    entry->index = system->observerFreeRecord;
+    system->observerFreeRecord = record + 1;
+}
+
+// Move an observer to a new chunk, recording the direction for prefetch
+// Out of memory it stays in its old chunk and false is returned
+static bool relocate_observer(ChunkRenderSystem* system, size_t index, IntCoord chunk) {
+    IntCoord previous = system->observerChunks[index];
+    if (chunk.x == previous.x && chunk.y == previous.y) return true;
+    
+    // Reserved before unlinking, so a failure leaves the buckets untouched
+    if (!bucket_reserve(system, system->observerBucketCount + 1)) return false;
+    
+    uint32_t record = system->observerIds[index];
+    bucket_unlink(system, record, previous);
+    bucket_link(system, record, chunk);
+    
+    int dx = chunk.x - previous.x;
+    int dy = chunk.y - previous.y;
+    system->observerHeadings[index].x = dx > 0 ? 1 : (dx < 0 ? -1 : 0);
+    system->observerHeadings[index].y = dy > 0 ? 1 : (dy < 0 ? -1 : 0);
+    system->observerChunks[index] = chunk;
+    return true;
+}
+
+static void set_manual_tile(ChunkRenderSystem* system, uint32_t record, int tileX, int tileY) {
+    size_t index = system->observerRecords[record].index;
+    Observer moved = system->observers[index];
+    moved.data.manual.tileX = tileX;
+    moved.data.manual.tileY = tileY;
+    
+    // Another manual observer already stands there; the two would be
+    // duplicates, so the moving one is dropped
+    uint32_t occupant = key_lookup(system, &moved);
+    if (occupant != OBSERVER_NONE) {
+        if (occupant != record) {
+            remove_record(system, record);
+        }
+        return;
+    }
+    
+    // Relocate first: out of memory the observer keeps its old tile, as
+    // manual observers are not polled again
+    IntCoord chunk;
+    ChunkRenderSystem_get_chunk_coord(system, tileX, tileY, &chunk.x, &chunk.y);
+    if (!relocate_observer(system, index, chunk)) return;
+    
+    key_remove(system, record);
+    system->observers[index] = moved;
+    key_insert(system, record);
+}
+
+void chunk_observers_poll(ChunkRenderSystem* system, ECS* ecs, ComponentTypeId positionTypeId) {
+    // Manual observers report their own moves; only entity positions are read
+    // An entity that could not be relocated is retried on the next poll
+    for (size_t i = 0; i < system->entityObserverCount; i++) {
+        IntCoord chunk;
+        observer_tile_chunk(system, &system->observers[i], ecs, positionTypeId, &chunk);
+        relocate_observer(system, i, chunk);
+    }
+}
+
+size_t chunk_observers_collect_chunks(ChunkRenderSystem* system, IntCoord* out) {
+    size_t count = 0;
+    for (size_t i = 0; i < system->observerBucketCapacity; i++) {
+        if (system->observerBuckets[i].count) {
+            out[count++] = system->observerBuckets[i].chunk;
+        }
+    }
+    return count;
+}
+
+bool chunk_observers_claim_edge(ChunkRenderSystem* system, IntCoord chunk, IntCoord heading) {
+    if (system->observerBucketCapacity == 0) return true;
+    
+    bool found;
+    ChunkObserverBucket* bucket = bucket_find(system, chunk, &found);
+    if (!found) return true;
+    
+    uint16_t bit = (uint16_t)(1u << ((heading.y + 1) * 3 + (heading.x + 1)));
+    if (bucket->edgeFrame != system->currentFrame) {
+        bucket->edgeFrame = system->currentFrame;
+        bucket->edgeHeadings = 0;
+    }
+    if (bucket->edgeHeadings & bit) return false;
+    bucket->edgeHeadings |= bit;
+    return true;
+}
+
+void chunk_observers_release(ChunkRenderSystem* system) {
+    free(system->observers);
+    free(system->observerChunks);
+    free(system->observerHeadings);
+    free(system->observerIds);
+    free(system->observerRecords);
+    free(system->observerKeys);
+    free(system->observerBuckets);
+    system->observers = NULL;
+    system->observerChunks = NULL;
+    system->observerHeadings = NULL;
+    system->observerIds = NULL;
+    system->observerRecords = NULL;
+    system->observerKeys = NULL;
+    system->observerBuckets = NULL;
+    system->observerCount = 0;
+    system->entityObserverCount = 0;
+    system->observerCapacity = 0;
+    system->observerRecordCount = 0;
+    system->observerRecordCapacity = 0;
+    system->observerFreeRecord = 0;
+    system->observerKeyCapacity = 0;
+    system->observerBucketCount = 0;
+    system->observerBucketCapacity = 0;
+}
+
+ChunkObserverHandle ChunkRenderSystem_add_entity_observer(ChunkRenderSystem* system,
+                                                          ECS* ecs,
+                                                          EntityId entity,
+                                                          ComponentTypeId positionTypeId) {
+    Observer observer;
+    memset(&observer, 0, sizeof(observer));
+    observer.type = OBSERVER_ENTITY;
+    observer.data.entityId = entity;
+    
+    IntCoord chunk;
+    observer_tile_chunk(system, &observer, ecs, positionTypeId, &chunk);
+    return add_observer(system, &observer, chunk);
+}
+
+ChunkObserverHandle ChunkRenderSystem_add_manual_observer(ChunkRenderSystem* system, int tileX, int tileY) {
+    Observer observer;
+    memset(&observer, 0, sizeof(observer));
+    observer.type = OBSERVER_MANUAL;
+    observer.data.manual.tileX = tileX;
+    observer.data.manual.tileY = tileY;
+    
+    IntCoord chunk;
+    ChunkRenderSystem_get_chunk_coord(system, tileX, tileY, &chunk.x, &chunk.y);
+    return add_observer(system, &observer, chunk);
+}
+
+void ChunkRenderSystem_move_manual_observer(ChunkRenderSystem* system,
+                                            int oldTileX, int oldTileY,
+                                            int newTileX, int newTileY) {
+    Observer key;
+    memset(&key, 0, sizeof(key));
+    key.type = OBSERVER_MANUAL;
+    key.data.manual.tileX = oldTileX;
+    key.data.manual.tileY = oldTileY;
+    
+    uint32_t record = key_lookup(system, &key);
+    if (record != OBSERVER_NONE) {
+        set_manual_tile(system, record, newTileX, newTileY);
+    }
+}
+
+void ChunkRenderSystem_move_observer(ChunkRenderSystem* system, ChunkObserverHandle handle, int tileX, int tileY) {
+    uint32_t record = handle_record(system, handle);
+    if (record == OBSERVER_NONE || record_observer(system, record)->type != OBSERVER_MANUAL) return;
+    set_manual_tile(system, record, tileX, tileY);
+}
+
+void ChunkRenderSystem_remove_entity_observer(ChunkRenderSystem* system, EntityId entity) {
+    Observer key;
+    memset(&key, 0, sizeof(key));
+    key.type = OBSERVER_ENTITY;
+    key.data.entityId = entity;
+    
+    uint32_t record = key_lookup(system, &key);
+    if (record != OBSERVER_NONE) {
+        remove_record(system, record);
+    }
+}
+
+void ChunkRenderSystem_remove_manual_observer(ChunkRenderSystem* system, int tileX, int tileY) {
+    Observer key;
+    memset(&key, 0, sizeof(key));
+    key.type = OBSERVER_MANUAL;
+    key.data.manual.tileX = tileX;
+    key.data.manual.tileY = tileY;
+    
+    uint32_t record = key_lookup(system, &key);
+    if (record != OBSERVER_NONE) {
+        remove_record(system, record);
+    }
+}
+
+void ChunkRenderSystem_remove_observer(ChunkRenderSystem* system, ChunkObserverHandle handle) {
+    uint32_t record = handle_record(system, handle);
+    if (record != OBSERVER_NONE) {
+        remove_record(system, record);
+    }
+}
+
+size_t ChunkRenderSystem_get_observers_in_chunk(ChunkRenderSystem* system, int chunkX, int chunkY,
+                                                ChunkObserverHandle* outHandles, size_t maxHandles) {
+    if (system->observerBucketCapacity == 0) return 0;
+    
+    IntCoord chunk = {chunkX, chunkY};
+    bool found;
+    ChunkObserverBucket* bucket = bucket_find(system, chunk, &found);
+    if (!found) return 0;
+    
+    size_t written = 0;
+    for (uint32_t record = bucket->head; record != OBSERVER_NONE && written < maxHandles;
+         record = system->observerRecords[record].nextInChunk) {
+        outHandles[written++] = make_handle(system, record);
+    }
+    return bucket->count;
+}
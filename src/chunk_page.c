@@ -0,0 +1,295 @@
+#include "chunk_render_internal.h"
+#include <string.h>
+
+static RenderColor color_white(void) {
+    RenderColor c = {255, 255, 255, 255};
+    return c;
+}
+
+static int cells_per_page(ChunkRenderSystem* system) {
+    return system->pageChunks * system->pageChunks;
+}
+
+static float chunk_pixel_size(ChunkRenderSystem* system) {
+    return (float)(system->chunkSize * system->tileSize);
+}
+
+static int page_pixel_size(ChunkRenderSystem* system) {
+    return system->pageChunks * system->chunkSize * system->tileSize;
+}
+
+size_t chunk_page_bytes(ChunkRenderSystem* system) {
+    size_t pageSize = (size_t)page_pixel_size(system);
+    return system->pageCount * pageSize * pageSize * 4;
+}
+
+// Source rect of a cell inside its page texture
+// Render textures are stored bottom-up, so rows are counted from the bottom
+// and the height is negative, matching how single chunk textures are drawn
+static RenderRect cell_src_rect(ChunkRenderSystem* system, int cell) {
+    int local = cell % cells_per_page(system);
+    float size = chunk_pixel_size(system);
+    float pageSize = size * (float)system->pageChunks;
+    RenderRect rect = {
+        (float)(local % system->pageChunks) * size,
+        pageSize - (float)(local / system->pageChunks + 1) * size,
+        size,
+        -size
+    };
+    return rect;
+}
+
+static bool add_page(ChunkRenderSystem* system) {
+    int pageSize = page_pixel_size(system);
+    void* page = system->backend->create_render_texture(system->backendContext, pageSize, pageSize);
+    if (!page) return false;
+    
+    if (system->pageCount == system->pageCapacity) {
+        size_t newCapacity = system->pageCapacity ? system->pageCapacity * 2 : 4;
+        void** pages = (void**)chunk_arena_alloc(system, sizeof(void*) * newCapacity, __FILE__, __LINE__);
+        int* usedCells = (int*)chunk_arena_alloc(system, sizeof(int) * newCapacity, __FILE__, __LINE__);
+        if (system->pageCount > 0) {
+            memcpy(pages, system->pages, sizeof(void*) * system->pageCount);
+            memcpy(usedCells, system->pageUsedCells, sizeof(int) * system->pageCount);
+        }
+        system->pages = pages;
+        system->pageUsedCells = usedCells;
+        system->pageCapacity = newCapacity;
+    }
+    
+    // The free list can hold every cell, so releasing never has to grow it
+    size_t cells = (size_t)cells_per_page(system);
+    size_t neededFree = (system->pageCount + 1) * cells;
+    if (neededFree > system->pageFreeCapacity) {
+        size_t newCapacity = system->pageFreeCapacity ? system->pageFreeCapacity : cells;
+        while (newCapacity < neededFree) {
+            newCapacity *= 2;
+        }
+        int* freeCells = (int*)chunk_arena_alloc(system, sizeof(int) * newCapacity, __FILE__, __LINE__);
+        if (system->pageFreeCount > 0) {
+            memcpy(freeCells, system->pageFreeCells, sizeof(int) * system->pageFreeCount);
+        }
+        system->pageFreeCells = freeCells;
+        system->pageFreeCapacity = newCapacity;
+    }
+    
+    // Push in reverse so cells are handed out in row-major order
+    int firstCell = (int)system->pageCount * (int)cells;
+    for (int i = (int)cells - 1; i >= 0; i--) {
+        system->pageFreeCells[system->pageFreeCount++] = firstCell + i;
+    }
+    system->pageUsedCells[system->pageCount] = 0;
+    system->pages[system->pageCount++] = page;
+    return true;
+}
+
+// Destroy pages at the end of the list once none of their cells is in use
+static void trim_pages(ChunkRenderSystem* system) {
+    int cells = cells_per_page(system);
+    while (system->pageCount > 0 && system->pageUsedCells[system->pageCount - 1] == 0) {
+        int firstCell = (int)(system->pageCount - 1) * cells;
+        size_t kept = 0;
+        for (size_t i = 0; i < system->pageFreeCount; i++) {
+            if (system->pageFreeCells[i] < firstCell) {
+                system->pageFreeCells[kept++] = system->pageFreeCells[i];
+            }
+        }
+        system->pageFreeCount = kept;
+        
+        system->pageCount--;
+        if (system->backendContext) {
+            system->backend->destroy_render_texture(system->backendContext, system->pages[system->pageCount]);
+        }
+    }
+}
+
+static bool acquire_cell(ChunkRenderSystem* system, ChunkSlot* slot) {
+    if (slot->hasPageCell) return true;
+    if (system->pageFreeCount == 0 && !add_page(system)) return false;
+    
+    // Lowest free cell first, so the last pages drain and can be trimmed
+    size_t best = system->pageFreeCount - 1;
+    for (size_t i = 0; i < system->pageFreeCount; i++) {
+        if (system->pageFreeCells[i] < system->pageFreeCells[best]) best = i;
+    }
+    slot->pageCell = system->pageFreeCells[best];
+    system->pageFreeCells[best] = system->pageFreeCells[--system->pageFreeCount];
+    system->pageUsedCells[slot->pageCell / cells_per_page(system)]++;
+    slot->hasPageCell = true;
+    slot->pageValid = false;
+    return true;
+}
+
+static void copy_to_page(ChunkRenderSystem* system, ChunkSlot* slot) {
+    void* source = system->backend->get_render_texture_texture(system->backendContext, slot->data.renderTexture);
+    if (!source) return;
+    
+    int local = slot->pageCell % cells_per_page(system);
+    float size = chunk_pixel_size(system);
+    RenderCommand copyCmd = {
+        .type = RENDER_COMMAND_TYPE_TEXTURE_PRO,
+        .bounds = {
+            (float)(local % system->pageChunks) * size,
+            (float)(local / system->pageChunks) * size,
+            size,
+            size
+        },
+        .color = color_white(),
+        .data.texture = {
+            .textureHandle = source,
+            .srcRect = {0, 0, size, -size},
+            .rotation = 0.0f,
+            .origin = {0, 0}
+        }
+    };
+    
+    system->backend->begin_render_texture(system->backendContext, system->pages[slot->pageCell / cells_per_page(system)]);
+    system->backend->execute_command(system->backendContext, &copyCmd);
+    system->backend->end_render_texture(system->backendContext);
+    CHUNK_STAT_ADD(system, drawCommands, 1);
+    
+    slot->pageValid = true;
+}
+
+// Once the cell holds the image the chunk's own target goes back to the
+// pool, so a packed chunk is stored once; mirrors eviction, minus the cell
+// Kept while LOD is enabled, as LOD levels are downsampled from it
+static void release_own_target(ChunkRenderSystem* system, ChunkSlot* slot) {
+    if (system->lodMaxLevel > 0 || !slot->pageValid) return;
+    
+    chunk_disk_cache_queue(system, slot);
+    if (!chunk_dedup_release(system, slot)) {
+        chunk_render_target_release(system, slot->data.renderTexture);
+    }
+    slot->data.renderTexture = NULL;
+    slot->pageOnly = true;
+    system->pageOnlyChunks++;
+}
+
+void chunk_page_update(ChunkRenderSystem* system) {
+    if (system->pageChunks <= 0 || !system->backendContext) return;
+    
+    for (size_t i = 0; i < system->coverageSpanCount; i++) {
+        const ChunkSpan* span = &system->coverageSpans[i];
+        for (int chunkX = span->minChunkX; chunkX <= span->maxChunkX; chunkX++) {
+            IntCoord coord = {chunkX, span->chunkY};
+            ChunkSlot* slot = (ChunkSlot*)Table_get(system->chunks, &coord);
+            if (!slot || !slot->data.isLoaded || slot->pageValid || !slot->data.renderTexture) continue;
+            if (!acquire_cell(system, slot)) return;
+            
+            copy_to_page(system, slot);
+            release_own_target(system, slot);
+        }
+    }
+}
+
+void chunk_page_release(ChunkRenderSystem* system, ChunkSlot* slot) {
+    if (!slot->hasPageCell) return;
+    
+    system->pageFreeCells[system->pageFreeCount++] = slot->pageCell;
+    system->pageUsedCells[slot->pageCell / cells_per_page(system)]--;
+    slot->hasPageCell = false;
+    slot->pageValid = false;
+    trim_pages(system);
+}
+
+bool chunk_page_queue(ChunkRenderSystem* system, ChunkSlot* slot, RenderRect dstRect) {
+    if (!slot->hasPageCell || !slot->pageValid) return false;
+    
+    if (system->pageDrawCount == system->pageDrawCapacity) {
+        size_t newCapacity = system->pageDrawCapacity ? system->pageDrawCapacity * 2 : 64;
+        ChunkTileQuad* quads = (ChunkTileQuad*)chunk_arena_alloc(system, sizeof(ChunkTileQuad) * newCapacity, __FILE__, __LINE__);
+        int* cells = (int*)chunk_arena_alloc(system, sizeof(int) * newCapacity, __FILE__, __LINE__);
+        ChunkTileQuad* sorted = (ChunkTileQuad*)chunk_arena_alloc(system, sizeof(ChunkTileQuad) * newCapacity, __FILE__, __LINE__);
+        if (system->pageDrawCount > 0) {
+            memcpy(quads, system->pageDrawQuads, sizeof(ChunkTileQuad) * system->pageDrawCount);
+            memcpy(cells, system->pageDrawCells, sizeof(int) * system->pageDrawCount);
+        }
+        system->pageDrawQuads = quads;
+        system->pageDrawCells = cells;
+        system->pageDrawSorted = sorted;
+        system->pageDrawCapacity = newCapacity;
+    }
+    
+    ChunkTileQuad* quad = &system->pageDrawQuads[system->pageDrawCount];
+    quad->srcRect = cell_src_rect(system, slot->pageCell);
+    quad->dstRect = dstRect;
+    system->pageDrawCells[system->pageDrawCount] = slot->pageCell;
+    system->pageDrawCount++;
+    return true;
+}
+
+static void submit_page(ChunkRenderSystem* system, void* pageTexture, const ChunkTileQuad* quads, size_t count) {
+    if (system->batchSubmit &&
+        system->batchSubmit(system->renderer, pageTexture, quads, count, system->batchSubmitUserData)) {
+        CHUNK_STAT_ADD(system, drawCommands, 1);
+        return;
+    }
+    
+    // No batch support: still one texture for the whole run of commands
+    RenderCommand texProCmd = {
+        .type = RENDER_COMMAND_TYPE_TEXTURE_PRO,
+        .color = color_white(),
+        .data.texture = {
+            .textureHandle = pageTexture,
+            .rotation = 0.0f,
+            .origin = {0, 0}
+        }
+    };
+    for (size_t i = 0; i < count; i++) {
+        texProCmd.bounds = quads[i].dstRect;
+        texProCmd.data.texture.srcRect = quads[i].srcRect;
+        system->backend->execute_command(system->backendContext, &texProCmd);
+    }
+    CHUNK_STAT_ADD(system, drawCommands, count);
+}
+
+void chunk_page_flush(ChunkRenderSystem* system) {
+    int cellsPerPage = cells_per_page(system);
+    
+    // Group queued quads by page, keeping draw order within a page
+    for (size_t page = 0; page < system->pageCount && system->pageDrawCount > 0; page++) {
+        size_t count = 0;
+        for (size_t i = 0; i < system->pageDrawCount; i++) {
+            if ((size_t)(system->pageDrawCells[i] / cellsPerPage) == page) {
+                system->pageDrawSorted[count++] = system->pageDrawQuads[i];
+            }
+        }
+        if (count == 0) continue;
+        
+        void* pageTexture = system->backend->get_render_texture_texture(system->backendContext, system->pages[page]);
+        if (pageTexture) {
+            submit_page(system, pageTexture, system->pageDrawSorted, count);
+        }
+    }
+    system->pageDrawCount = 0;
+}
+
+void chunk_page_release_all(ChunkRenderSystem* system) {
+    for (ChunkSlot* slot = system->residentHead; slot; slot = slot->next) {
+        slot->hasPageCell = false;
+        slot->pageValid = false;
+        // Its only image goes with the page; the rebuild takes a target again
+        if (slot->pageOnly) {
+            slot->data.isDirty = true;
+        }
+    }
+    for (size_t i = 0; i < system->pageCount; i++) {
+        if (system->backendContext) {
+            system->backend->destroy_render_texture(system->backendContext, system->pages[i]);
+        }
+    }
+    system->pageCount = 0;
+    system->pageFreeCount = 0;
+    system->pageDrawCount = 0;
+}
+
+void ChunkRenderSystem_enable_page_packing(ChunkRenderSystem* system, int pageChunks) {
+    if (!system) return;
+    if (pageChunks < 0) pageChunks = 0;
+    if (pageChunks == system->pageChunks) return;
+    
+    // Cell layout depends on the page size, so existing pages are dropped
+    chunk_page_release_all(system);
+    system->pageChunks = pageChunks;
+}
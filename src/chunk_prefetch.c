@@ -0,0 +1,460 @@
+#include "chunk_render_internal.h"
+#include "chunk_thread.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if CHUNK_RENDER_HAS_THREADS
+
+typedef enum ChunkPrefetchState {
+    PREFETCH_FREE,
+    PREFETCH_PENDING,            // Waiting for the worker
+    PREFETCH_RUNNING,            // Worker is building it
+    PREFETCH_READY,              // Quads built, waiting for upload
+    PREFETCH_UPLOADING           // Main thread is uploading it
+} ChunkPrefetchState;
+
+typedef struct PrefetchCandidate {
+    int chunkX;
+    int chunkY;
+    int distSq;
+} PrefetchCandidate;
+
+// Main-thread copy of an entry, taken so candidates are picked without the lock
+typedef struct PrefetchEntryView {
+    ChunkPrefetchState state;
+    int chunkX;
+    int chunkY;
+    bool recycle;                // READY result to drop when claiming
+} PrefetchEntryView;
+
+typedef struct ChunkPrefetchEntry {
+    ChunkPrefetchState state;
+    int chunkX;
+    int chunkY;
+    bool stale;                  // Tiles changed after the job was queued
+    uint32_t atlasVersion;       // Atlas version the quads were built with
+    size_t quadCount;
+    int* tileIds;
+    ChunkTileQuad* quads;
+} ChunkPrefetchEntry;
+
+struct ChunkPrefetch {
+    ChunkRenderSystem* system;
+    ChunkPrefetchEntry* entries;
+    int entryCount;
+    
+    ChunkMutex mutex;            // Guards entry states and quit
+    ChunkCond wake;
+    ChunkMutex atlasMutex;       // Held by the worker while reading the atlas table
+    ChunkThread thread;
+    bool quit;
+    
+    PrefetchCandidate* candidates;
+    PrefetchEntryView* views;
+};
+
+static void worker_main(void* arg) {
+    ChunkPrefetch* prefetch = (ChunkPrefetch*)arg;
+    ChunkRenderSystem* system = prefetch->system;
+    ChunkTileRegion region = {0, 0, system->chunkSize, system->chunkSize};
+    
+    ChunkMutex_lock(&prefetch->mutex);
+    while (!prefetch->quit) {
+        ChunkPrefetchEntry* entry = NULL;
+        for (int i = 0; i < prefetch->entryCount; i++) {
+            if (prefetch->entries[i].state == PREFETCH_PENDING) {
+                entry = &prefetch->entries[i];
+                break;
+            }
+        }
+        if (!entry) {
+            ChunkCond_wait(&prefetch->wake, &prefetch->mutex);
+            continue;
+        }
+        
+        entry->state = PREFETCH_RUNNING;
+        ChunkMutex_unlock(&prefetch->mutex);
+        
+        chunk_gather_tile_ids(system, entry->chunkX, entry->chunkY, &region, entry->tileIds);
+        ChunkMutex_lock(&prefetch->atlasMutex);
+        entry->atlasVersion = system->atlasVersion;
+        entry->quadCount = chunk_build_tile_quads(system, entry->tileIds, &region, entry->quads, true);
+        ChunkMutex_unlock(&prefetch->atlasMutex);
+        
+        ChunkMutex_lock(&prefetch->mutex);
+        entry->state = entry->stale ? PREFETCH_FREE : PREFETCH_READY;
+    }
+    ChunkMutex_unlock(&prefetch->mutex);
+}
+
+static ChunkPrefetchEntry* find_entry(ChunkPrefetch* prefetch, int chunkX, int chunkY) {
+    for (int i = 0; i < prefetch->entryCount; i++) {
+        ChunkPrefetchEntry* entry = &prefetch->entries[i];
+        if (entry->state != PREFETCH_FREE && entry->chunkX == chunkX && entry->chunkY == chunkY) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+// Drop an entry that can no longer be used; a running job frees itself
+static void discard_entry(ChunkPrefetchEntry* entry) {
+    if (entry->state == PREFETCH_RUNNING) {
+        entry->stale = true;
+    } else {
+        entry->state = PREFETCH_FREE;
+    }
+}
+
+bool chunk_prefetch_upload(ChunkRenderSystem* system, ChunkRenderData* chunk) {
+    ChunkPrefetch* prefetch = system->prefetch;
+    if (!prefetch) return false;
+    
+    ChunkMutex_lock(&prefetch->mutex);
+    ChunkPrefetchEntry* entry = find_entry(prefetch, chunk->chunkX, chunk->chunkY);
+    bool usable = entry && entry->state == PREFETCH_READY && !entry->stale &&
+                  entry->atlasVersion == system->atlasVersion;
+    if (usable) {
+        entry->state = PREFETCH_UPLOADING;
+    } else if (entry) {
+        // Rebuilt synchronously now, so a pending or outdated job is useless
+        discard_entry(entry);
+    }
+    ChunkMutex_unlock(&prefetch->mutex);
+    if (!usable) return false;
+    
+    chunk_upload_tile_quads(system, chunk, entry->quads, entry->quadCount);
+    
+    ChunkMutex_lock(&prefetch->mutex);
+    entry->state = PREFETCH_FREE;
+    ChunkMutex_unlock(&prefetch->mutex);
+    return true;
+}
+
+void chunk_prefetch_invalidate(ChunkRenderSystem* system, int chunkX, int chunkY) {
+    ChunkPrefetch* prefetch = system->prefetch;
+    if (!prefetch) return;
+    
+    ChunkMutex_lock(&prefetch->mutex);
+    ChunkPrefetchEntry* entry = find_entry(prefetch, chunkX, chunkY);
+    if (entry && entry->state != PREFETCH_UPLOADING) {
+        discard_entry(entry);
+    }
+    ChunkMutex_unlock(&prefetch->mutex);
+}
+
+void chunk_prefetch_lock_atlas(ChunkRenderSystem* system) {
+    if (system->prefetch) {
+        ChunkMutex_lock(&system->prefetch->atlasMutex);
+    }
+}
+
+void chunk_prefetch_unlock_atlas(ChunkRenderSystem* system) {
+    if (system->prefetch) {
+        ChunkMutex_unlock(&system->prefetch->atlasMutex);
+    }
+}
+
+static bool needs_prefetch(ChunkRenderSystem* system, int chunkX, int chunkY) {
+    IntCoord coord = {chunkX, chunkY};
+    ChunkRenderData* chunk = (ChunkRenderData*)Table_get(system->chunks, &coord);
+    return !chunk || !chunk->isLoaded || chunk->isDirty;
+}
+
+// Keep the best `limit` candidates sorted by distance (nearest first)
+static int insert_candidate(PrefetchCandidate* best, int count, int limit, PrefetchCandidate candidate) {
+    for (int i = 0; i < count; i++) {
+        if (best[i].chunkX == candidate.chunkX && best[i].chunkY == candidate.chunkY) {
+            if (candidate.distSq >= best[i].distSq) return count;
+            memmove(&best[i], &best[i + 1], sizeof(PrefetchCandidate) * (size_t)(count - i - 1));
+            count--;
+            break;
+        }
+    }
+    
+    int pos = count;
+    while (pos > 0 && best[pos - 1].distSq > candidate.distSq) {
+        pos--;
+    }
+    if (pos >= limit) return count;
+    
+    int moved = (count < limit ? count : limit - 1) - pos;
+    if (moved > 0) {
+        memmove(&best[pos + 1], &best[pos], sizeof(PrefetchCandidate) * (size_t)moved);
+    }
+    best[pos] = candidate;
+    return count < limit ? count + 1 : limit;
+}
+
+// Already queued, being built or waiting for upload (per the snapshot)
+static bool view_busy(const ChunkPrefetch* prefetch, int chunkX, int chunkY) {
+    for (int i = 0; i < prefetch->entryCount; i++) {
+        const PrefetchEntryView* view = &prefetch->views[i];
+        if (view->state != PREFETCH_FREE && !view->recycle &&
+            view->chunkX == chunkX && view->chunkY == chunkY) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// outCut is set when a chunk that needs preparing did not fit the buffers
+static int consider_cell(ChunkRenderSystem* system, ChunkPrefetch* prefetch, IntCoord center,
+                         int dx, int dy, PrefetchCandidate* best, int bestCount, int limit, bool* outCut) {
+    PrefetchCandidate candidate = {center.x + dx, center.y + dy, dx * dx + dy * dy};
+    if (view_busy(prefetch, candidate.chunkX, candidate.chunkY)) return bestCount;
+    if (!needs_prefetch(system, candidate.chunkX, candidate.chunkY)) return bestCount;
+    if (bestCount == limit) {
+        *outCut = true;
+        if (candidate.distSq >= best[bestCount - 1].distSq) return bestCount;
+    }
+    return insert_candidate(best, bestCount, limit, candidate);
+}
+
+// Chunks the next steps along the heading bring into the render disc, up to
+// the simulation radius: per step and row, the cells of the disc moved that
+// far ahead outside the disc one step behind, so only the leading edge
+// strips are visited (coverage half-widths are reused). A disc translated
+// along a line only overlaps the current one inside the disc one step
+// behind, so each ring chunk ahead is visited once
+static int gather_edge(ChunkRenderSystem* system, ChunkPrefetch* prefetch, IntCoord center, IntCoord heading,
+                       PrefetchCandidate* best, int bestCount, int limit, bool* outCut) {
+    int radius = system->coverageRadius < 0 ? 0 : system->coverageRadius;
+    int steps = system->simulationRadius - radius;
+    const int* halfWidths = system->coverageHalfWidths;
+    
+    for (int step = 1; step <= steps; step++) {
+        IntCoord ahead = {heading.x * step, heading.y * step};
+        IntCoord behind = {ahead.x - heading.x, ahead.y - heading.y};
+        
+        for (int dy = ahead.y - radius; dy <= ahead.y + radius; dy++) {
+            int aheadHalfWidth = halfWidths[radius + dy - ahead.y];
+            int minX = ahead.x - aheadHalfWidth;
+            int maxX = ahead.x + aheadHalfWidth;
+            
+            // Part of the row already inside the disc one step behind
+            int coveredMin = 1, coveredMax = 0;
+            if (dy >= behind.y - radius && dy <= behind.y + radius) {
+                coveredMin = behind.x - halfWidths[radius + dy - behind.y];
+                coveredMax = behind.x + halfWidths[radius + dy - behind.y];
+            }
+            
+            for (int dx = minX; dx <= maxX; dx++) {
+                if (dx >= coveredMin && dx <= coveredMax) {
+                    dx = coveredMax;
+                    continue;
+                }
+                bestCount = consider_cell(system, prefetch, center, dx, dy, best, bestCount, limit, outCut);
+            }
+        }
+    }
+    return bestCount;
+}
+
+static bool any_heading(ChunkRenderSystem* system) {
+    for (size_t i = 0; i < system->observerCount; i++) {
+        if (system->observerHeadings[i].x != 0 || system->observerHeadings[i].y != 0) return true;
+    }
+    return false;
+}
+
+void chunk_prefetch_schedule(ChunkRenderSystem* system) {
+    ChunkPrefetch* prefetch = system->prefetch;
+    if (!prefetch || system->simulationRadius <= system->renderRadius) return;
+    
+    if (!system->coverageHalfWidths) return;
+    int64_t ringOuterSq = (int64_t)system->simulationRadius * system->simulationRadius;
+    
+    // Snapshot the entries; only this thread moves entries out of FREE or
+    // READY, so the free ones are still free when they are claimed below
+    int freeCount = 0;
+    ChunkMutex_lock(&prefetch->mutex);
+    for (int i = 0; i < prefetch->entryCount; i++) {
+        PrefetchEntryView* view = &prefetch->views[i];
+        view->state = prefetch->entries[i].state;
+        view->chunkX = prefetch->entries[i].chunkX;
+        view->chunkY = prefetch->entries[i].chunkY;
+        view->recycle = false;
+        if (view->state == PREFETCH_FREE) {
+            freeCount++;
+        }
+    }
+    ChunkMutex_unlock(&prefetch->mutex);
+    
+    // With every buffer taken, ready results nobody is heading towards any
+    // more are recycled (only worth checking when a new edge is waiting)
+    int recycled = 0;
+    if (freeCount == 0) {
+        if (!any_heading(system)) return;
+        for (int i = 0; i < prefetch->entryCount; i++) {
+            PrefetchEntryView* view = &prefetch->views[i];
+            if (view->state == PREFETCH_READY &&
+                chunk_coverage_nearest_dist_sq(system, view->chunkX, view->chunkY) > ringOuterSq) {
+                view->recycle = true;
+                recycled++;
+            }
+        }
+        // Headings are kept until a buffer frees up
+        if (recycled == 0) return;
+        freeCount = recycled;
+    }
+    
+    // Each crossing scans the ring ahead once, nearest first: the heading
+    // is cleared afterwards, so observers that stopped cost nothing. A scan
+    // cut short by the buffer limit keeps its heading and runs again next
+    // update, once buffers have been uploaded
+    PrefetchCandidate* best = prefetch->candidates;
+    int bestCount = 0;
+    for (size_t i = 0; i < system->observerCount; i++) {
+        IntCoord heading = system->observerHeadings[i];
+        if (heading.x == 0 && heading.y == 0) continue;
+        
+        IntCoord center = system->observerChunks[i];
+        bool cut = false;
+        if (chunk_observers_claim_edge(system, center, heading)) {
+            bestCount = gather_edge(system, prefetch, center, heading, best, bestCount, freeCount, &cut);
+        }
+        if (!cut) {
+            system->observerHeadings[i].x = 0;
+            system->observerHeadings[i].y = 0;
+        }
+    }
+    if (bestCount == 0 && recycled == 0) return;
+    
+    ChunkMutex_lock(&prefetch->mutex);
+    int next = 0;
+    for (int i = 0; i < prefetch->entryCount; i++) {
+        ChunkPrefetchEntry* entry = &prefetch->entries[i];
+        if (prefetch->views[i].recycle) {
+            entry->state = PREFETCH_FREE;
+        }
+        if (entry->state != PREFETCH_FREE || next >= bestCount) continue;
+        
+        entry->chunkX = best[next].chunkX;
+        entry->chunkY = best[next].chunkY;
+        entry->stale = false;
+        entry->quadCount = 0;
+        entry->state = PREFETCH_PENDING;
+        next++;
+    }
+    if (next > 0) {
+        ChunkCond_signal(&prefetch->wake);
+    }
+    ChunkMutex_unlock(&prefetch->mutex);
+}
+
+void chunk_prefetch_discard_if(ChunkRenderSystem* system, ChunkPrefetchDirtyFn isDirty, void* userData) {
+    ChunkPrefetch* prefetch = system->prefetch;
+    if (!prefetch) return;
+    
+    ChunkMutex_lock(&prefetch->mutex);
+    for (int i = 0; i < prefetch->entryCount; i++) {
+        ChunkPrefetchEntry* entry = &prefetch->entries[i];
+        if (entry->state != PREFETCH_FREE && entry->state != PREFETCH_UPLOADING &&
+            isDirty(userData, entry->chunkX, entry->chunkY)) {
+            discard_entry(entry);
+        }
+    }
+    ChunkMutex_unlock(&prefetch->mutex);
+}
+
+bool ChunkRenderSystem_enable_prefetch(ChunkRenderSystem* system, int bufferCount) {
+    if (!system || bufferCount <= 0) return false;
+    if (system->prefetch) {
+        ChunkRenderSystem_disable_prefetch(system);
+    }
+    
+    size_t tileCount = (size_t)system->chunkSize * (size_t)system->chunkSize;
+    ChunkPrefetch* prefetch = (ChunkPrefetch*)calloc(1, sizeof(ChunkPrefetch));
+    if (!prefetch) return false;
+    prefetch->system = system;
+    prefetch->entryCount = bufferCount;
+    prefetch->entries = (ChunkPrefetchEntry*)calloc((size_t)bufferCount, sizeof(ChunkPrefetchEntry));
+    prefetch->candidates = (PrefetchCandidate*)malloc(sizeof(PrefetchCandidate) * (size_t)bufferCount);
+    prefetch->views = (PrefetchEntryView*)calloc((size_t)bufferCount, sizeof(PrefetchEntryView));
+    bool ok = prefetch->entries && prefetch->candidates && prefetch->views;
+    for (int i = 0; ok && i < bufferCount; i++) {
+        prefetch->entries[i].tileIds = (int*)malloc(sizeof(int) * tileCount);
+        prefetch->entries[i].quads = (ChunkTileQuad*)malloc(sizeof(ChunkTileQuad) * tileCount);
+        ok = prefetch->entries[i].tileIds && prefetch->entries[i].quads;
+    }
+    
+    if (ok) {
+        ChunkMutex_init(&prefetch->mutex);
+        ChunkMutex_init(&prefetch->atlasMutex);
+        ChunkCond_init(&prefetch->wake);
+        ok = ChunkThread_start(&prefetch->thread, worker_main, prefetch);
+        if (!ok) {
+            ChunkCond_destroy(&prefetch->wake);
+            ChunkMutex_destroy(&prefetch->atlasMutex);
+            ChunkMutex_destroy(&prefetch->mutex);
+        }
+    }
+    
+    if (!ok) {
+        for (int i = 0; prefetch->entries && i < bufferCount; i++) {
+            free(prefetch->entries[i].tileIds);
+            free(prefetch->entries[i].quads);
+        }
+        free(prefetch->entries);
+        free(prefetch->candidates);
+        free(prefetch->views);
+        free(prefetch);
+        return false;
+    }
+    
+    system->prefetch = prefetch;
+    return true;
+}
+
+void ChunkRenderSystem_disable_prefetch(ChunkRenderSystem* system) {
+    if (!system || !system->prefetch) return;
+    ChunkPrefetch* prefetch = system->prefetch;
+    
+    ChunkMutex_lock(&prefetch->mutex);
+    prefetch->quit = true;
+    ChunkCond_broadcast(&prefetch->wake);
+    ChunkMutex_unlock(&prefetch->mutex);
+    ChunkThread_join(prefetch->thread);
+    
+    ChunkCond_destroy(&prefetch->wake);
+    ChunkMutex_destroy(&prefetch->atlasMutex);
+    ChunkMutex_destroy(&prefetch->mutex);
+    for (int i = 0; i < prefetch->entryCount; i++) {
+        free(prefetch->entries[i].tileIds);
+        free(prefetch->entries[i].quads);
+    }
+    free(prefetch->entries);
+    free(prefetch->candidates);
+    free(prefetch->views);
+    free(prefetch);
+    system->prefetch = NULL;
+}
+
+#else
+
+// No threads on this platform: prefetching is unavailable
+bool chunk_prefetch_upload(ChunkRenderSystem* system, ChunkRenderData* chunk) {
+    (void)system; (void)chunk;
+    return false;
+}
+void chunk_prefetch_invalidate(ChunkRenderSystem* system, int chunkX, int chunkY) {
+    (void)system; (void)chunkX; (void)chunkY;
+}
+void chunk_prefetch_lock_atlas(ChunkRenderSystem* system) { (void)system; }
+void chunk_prefetch_unlock_atlas(ChunkRenderSystem* system) { (void)system; }
+void chunk_prefetch_schedule(ChunkRenderSystem* system) { (void)system; }
+void chunk_prefetch_discard_if(ChunkRenderSystem* system, ChunkPrefetchDirtyFn isDirty, void* userData) {
+    (void)system; (void)isDirty; (void)userData;
+}
+
+bool ChunkRenderSystem_enable_prefetch(ChunkRenderSystem* system, int bufferCount) {
+    (void)system; (void)bufferCount;
+    return false;
+}
+
+void ChunkRenderSystem_disable_prefetch(ChunkRenderSystem* system) {
+    (void)system;
+}
+
+#endif
@@ -0,0 +1,141 @@
+#include "chunk_render_internal.h"
+#include <string.h>
+
+#define DEFAULT_JOB_BATCH 16
+#define JOBS_PER_THREAD 4        // Batch slack so stealing can balance uneven chunks
+#define BATCH_FOLLOWER ((size_t)-1)  // Quad count marking a copy of an earlier batch chunk
+
+static size_t chunk_tile_count(ChunkRenderSystem* system) {
+    return (size_t)system->chunkSize * (size_t)system->chunkSize;
+}
+
+static void reserve_batch(ChunkRenderSystem* system, size_t batchSize) {
+    system->rebuildBatchSize = batchSize;
+    if (batchSize <= system->rebuildBatchCapacity) return;
+    
+    size_t tiles = chunk_tile_count(system) * batchSize;
+    system->rebuildBatch = (ChunkSlot**)chunk_arena_alloc(system, sizeof(ChunkSlot*) * batchSize, __FILE__, __LINE__);
+    system->batchTileIds = (int*)chunk_arena_alloc(system, sizeof(int) * tiles, __FILE__, __LINE__);
+    system->batchQuads = (ChunkTileQuad*)chunk_arena_alloc(system, sizeof(ChunkTileQuad) * tiles, __FILE__, __LINE__);
+    system->batchQuadCounts = (size_t*)chunk_arena_alloc(system, sizeof(size_t) * batchSize, __FILE__, __LINE__);
+    system->rebuildBatchCapacity = batchSize;
+}
+
+static void release_pool(ChunkRenderSystem* system) {
+    chunk_job_pool_destroy(system->jobPool);
+    system->jobPool = NULL;
+    system->jobRun = NULL;
+    system->jobRunUserData = NULL;
+}
+
+// Job body: gather and build one chunk of the batch into its own buffers
+// Hashed rebuilds had their tile ids gathered by the cache probe already
+static void build_chunk_job(void* context, int index) {
+    ChunkRenderSystem* system = (ChunkRenderSystem*)context;
+    size_t offset = chunk_tile_count(system) * (size_t)index;
+    ChunkSlot* slot = system->rebuildBatch[index];
+    
+    if (system->batchQuadCounts[index] == BATCH_FOLLOWER) return;
+    if (chunk_rebuild_hashes(system, &slot->rebuildRegion)) {
+        system->batchQuadCounts[index] = chunk_build_tile_quads(system, system->batchTileIds + offset,
+                                                                &slot->rebuildRegion,
+                                                                system->batchQuads + offset, true);
+        return;
+    }
+    system->batchQuadCounts[index] = chunk_prepare_tiles(system, &slot->data, &slot->rebuildRegion,
+                                                         system->batchTileIds + offset,
+                                                         system->batchQuads + offset,
+                                                         true);
+}
+
+// A chunk with the same tiles as an earlier chunk of this batch shares its
+// texture once that one is registered, so it is not built (dedup only)
+static bool batch_has_copy(ChunkRenderSystem* system, ChunkSlot* slot, const int* tileIds, size_t count) {
+    if (!system->dedupEnabled || !slot->hasContentHash) return false;
+    
+    size_t chunkTiles = chunk_tile_count(system);
+    for (size_t i = 0; i < count; i++) {
+        ChunkSlot* other = system->rebuildBatch[i];
+        if (system->batchQuadCounts[i] != BATCH_FOLLOWER && other->hasContentHash &&
+            other->contentHash == slot->contentHash &&
+            memcmp(system->batchTileIds + chunkTiles * i, tileIds, sizeof(int) * chunkTiles) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int chunk_rebuild_batch(ChunkRenderSystem* system, int limit) {
+    size_t chunkTiles = chunk_tile_count(system);
+    size_t count = 0;
+    int popped = 0;
+    
+    while (system->rebuildQueueCount > 0 && popped < limit && count < system->rebuildBatchSize) {
+        ChunkSlot* slot = chunk_rebuild_queue_pop(system);
+        popped++;
+        
+        if (!chunk_rebuild_region(system, &slot->data, &slot->rebuildRegion)) {
+            slot->data.isDirty = false;
+            continue;
+        }
+        if (chunk_rebuild_from_prefetch(system, &slot->data, &slot->rebuildRegion)) continue;
+        
+        // Cache and dedup hits need only the tile ids, so they never reach the pool
+        int* tileIds = system->batchTileIds + chunkTiles * count;
+        if (chunk_rebuild_hashes(system, &slot->rebuildRegion)) {
+            chunk_gather_tile_ids(system, slot->data.chunkX, slot->data.chunkY, &slot->rebuildRegion, tileIds);
+        }
+        if (chunk_rebuild_from_cache(system, &slot->data, &slot->rebuildRegion, tileIds)) continue;
+        system->batchQuadCounts[count] = batch_has_copy(system, slot, tileIds, count) ? BATCH_FOLLOWER : 0;
+        system->rebuildBatch[count++] = slot;
+    }
+    if (count == 0) return popped;
+    
+    system->jobRun((int)count, build_chunk_job, system, system->jobRunUserData);
+    
+    // Uploads stay in queue order on the calling thread
+    for (size_t i = 0; i < count; i++) {
+        ChunkSlot* slot = system->rebuildBatch[i];
+        const int* tileIds = system->batchTileIds + chunkTiles * i;
+        ChunkTileQuad* quads = system->batchQuads + chunkTiles * i;
+        size_t quadCount = system->batchQuadCounts[i];
+        if (quadCount == BATCH_FOLLOWER) {
+            if (chunk_rebuild_from_cache(system, &slot->data, &slot->rebuildRegion, tileIds)) continue;
+            quadCount = chunk_build_tile_quads(system, tileIds, &slot->rebuildRegion, quads, false);
+        }
+        chunk_finish_tiles(system, &slot->data, &slot->rebuildRegion, tileIds, quads, quadCount);
+    }
+    return popped;
+}
+
+void chunk_rebuild_jobs_release(ChunkRenderSystem* system) {
+    release_pool(system);
+}
+
+bool ChunkRenderSystem_set_worker_threads(ChunkRenderSystem* system, int threadCount) {
+    if (!system) return false;
+    release_pool(system);
+    if (threadCount <= 1) return true;
+    
+    ChunkJobPool* pool = chunk_job_pool_create(threadCount);
+    if (!pool) return false;
+    
+    system->jobPool = pool;
+    system->jobRun = chunk_job_pool_run;
+    system->jobRunUserData = pool;
+    reserve_batch(system, (size_t)chunk_job_pool_thread_count(pool) * JOBS_PER_THREAD);
+    return true;
+}
+
+void ChunkRenderSystem_set_job_runner(ChunkRenderSystem* system,
+                                      ChunkRenderJobRunFn run,
+                                      void* userData,
+                                      int batchSize) {
+    if (!system) return;
+    release_pool(system);
+    if (!run) return;
+    
+    system->jobRun = run;
+    system->jobRunUserData = userData;
+    reserve_batch(system, batchSize > 0 ? (size_t)batchSize : DEFAULT_JOB_BATCH);
+}
@@ -0,0 +1,72 @@
+#include "chunk_render_internal.h"
+#include <string.h>
+
+// Nearer chunks first; among equally near chunks, the most recently dirtied
+static bool rebuild_before(const ChunkSlot* a, const ChunkSlot* b) {
+    if (a->priorityDistSq != b->priorityDistSq) {
+        return a->priorityDistSq < b->priorityDistSq;
+    }
+    return a->dirtyFrame > b->dirtyFrame;
+}
+
+static void sift_down(ChunkSlot** heap, size_t count, size_t index) {
+    for (;;) {
+        size_t best = index;
+        size_t left = index * 2 + 1;
+        size_t right = left + 1;
+        if (left < count && rebuild_before(heap[left], heap[best])) best = left;
+        if (right < count && rebuild_before(heap[right], heap[best])) best = right;
+        if (best == index) return;
+        
+        ChunkSlot* tmp = heap[index];
+        heap[index] = heap[best];
+        heap[best] = tmp;
+        index = best;
+    }
+}
+
+void chunk_rebuild_queue_push(ChunkRenderSystem* system, ChunkSlot* slot) {
+    if (slot->queued) return;
+    
+    if (system->rebuildQueueCount >= system->rebuildQueueCapacity) {
+        size_t newCapacity = system->rebuildQueueCapacity ? system->rebuildQueueCapacity * 2 : 64;
+        ChunkSlot** newQueue = (ChunkSlot**)chunk_arena_alloc(system, sizeof(ChunkSlot*) * newCapacity, __FILE__, __LINE__);
+        if (system->rebuildQueueCount > 0) {
+            memcpy(newQueue, system->rebuildQueue, sizeof(ChunkSlot*) * system->rebuildQueueCount);
+        }
+        system->rebuildQueue = newQueue;
+        system->rebuildQueueCapacity = newCapacity;
+    }
+    
+    // Keys can still change while observers are gathered, so the heap is
+    // only built in chunk_rebuild_queue_heapify
+    system->rebuildQueue[system->rebuildQueueCount++] = slot;
+    slot->queued = true;
+}
+
+void chunk_rebuild_queue_heapify(ChunkRenderSystem* system) {
+    size_t count = system->rebuildQueueCount;
+    for (size_t i = count / 2; i-- > 0;) {
+        sift_down(system->rebuildQueue, count, i);
+    }
+}
+
+ChunkSlot* chunk_rebuild_queue_pop(ChunkRenderSystem* system) {
+    if (system->rebuildQueueCount == 0) return NULL;
+    
+    ChunkSlot* top = system->rebuildQueue[0];
+    system->rebuildQueueCount--;
+    if (system->rebuildQueueCount > 0) {
+        system->rebuildQueue[0] = system->rebuildQueue[system->rebuildQueueCount];
+        sift_down(system->rebuildQueue, system->rebuildQueueCount, 0);
+    }
+    top->queued = false;
+    return top;
+}
+
+void chunk_rebuild_queue_clear(ChunkRenderSystem* system) {
+    for (size_t i = 0; i < system->rebuildQueueCount; i++) {
+        system->rebuildQueue[i]->queued = false;
+    }
+    system->rebuildQueueCount = 0;
+}
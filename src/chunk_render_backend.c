@@ -0,0 +1,61 @@
+#include "gramarye_chunk_renderer/chunk_render_backend.h"
+#include <stddef.h>
+
+static void* renderer_create_render_texture(void* context, int width, int height) {
+    return Renderer_create_render_texture((Renderer*)context, width, height);
+}
+
+static void renderer_destroy_render_texture(void* context, void* renderTexture) {
+    Renderer_destroy_render_texture((Renderer*)context, renderTexture);
+}
+
+static void renderer_begin_render_texture(void* context, void* renderTexture) {
+    Renderer_begin_render_texture((Renderer*)context, renderTexture);
+}
+
+static void renderer_end_render_texture(void* context) {
+    Renderer_end_render_texture((Renderer*)context);
+}
+
+static void renderer_execute_command(void* context, const RenderCommand* command) {
+    Renderer_execute_command((Renderer*)context, command);
+}
+
+static void* renderer_get_render_texture_texture(void* context, void* renderTexture) {
+    return Renderer_get_render_texture_texture((Renderer*)context, renderTexture);
+}
+
+static RenderVector2 renderer_world_to_screen(void* context, CameraHandle camera, AspectFitHandle aspectFit, RenderVector2 world) {
+    return Renderer_world_to_screen((Renderer*)context, camera, aspectFit, world);
+}
+
+static RenderVector2 renderer_screen_to_world(void* context, CameraHandle camera, AspectFitHandle aspectFit, RenderVector2 screen) {
+    return Renderer_screen_to_world((Renderer*)context, camera, aspectFit, screen);
+}
+
+static float renderer_get_camera_zoom(void* context, CameraHandle camera) {
+    return Renderer_get_camera_zoom((Renderer*)context, camera);
+}
+
+static float renderer_get_aspect_fit_scale(void* context, AspectFitHandle aspectFit) {
+    return Renderer_get_aspect_fit_scale((Renderer*)context, aspectFit);
+}
+
+static const ChunkRenderBackend RENDERER_BACKEND = {
+    renderer_create_render_texture,
+    renderer_destroy_render_texture,
+    renderer_begin_render_texture,
+    renderer_end_render_texture,
+    renderer_execute_command,
+    renderer_get_render_texture_texture,
+    renderer_world_to_screen,
+    renderer_screen_to_world,
+    renderer_get_camera_zoom,
+    renderer_get_aspect_fit_scale,
+    NULL,  // The Renderer interface has no pixel access
+    NULL
+};
+
+const ChunkRenderBackend* ChunkRenderBackend_renderer(void) {
+    return &RENDERER_BACKEND;
+}
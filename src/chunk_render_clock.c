@@ -0,0 +1,34 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "chunk_render_internal.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__EMSCRIPTEN__)
+#include <emscripten.h>
+#else
+#include <time.h>
+#endif
+
+uint64_t chunk_render_now_us(void) {
+#if defined(_WIN32)
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    QueryPerformanceCounter(&counter);
+    // Split into whole seconds and remainder so the multiply cannot overflow
+    uint64_t ticks = (uint64_t)counter.QuadPart;
+    uint64_t ticksPerSecond = (uint64_t)frequency.QuadPart;
+    return (ticks / ticksPerSecond) * 1000000u + (ticks % ticksPerSecond) * 1000000u / ticksPerSecond;
+#elif defined(__EMSCRIPTEN__)
+    return (uint64_t)(emscripten_get_now() * 1000.0);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+#endif
+}
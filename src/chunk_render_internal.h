@@ -0,0 +1,358 @@
+#ifndef CHUNK_RENDER_INTERNAL_H
+#define CHUNK_RENDER_INTERNAL_H
+
+#include "gramarye_chunk_renderer/chunk_render_system.h"
+
+// Stats and trace scopes are compiled out when the CMake option is off
+#ifndef GRAMARYE_CHUNK_RENDERER_STATS
+#define GRAMARYE_CHUNK_RENDERER_STATS 1
+#endif
+
+#if GRAMARYE_CHUNK_RENDERER_STATS
+#define CHUNK_STAT_ADD(system, field, amount) ((system)->statsCurrent.field += (amount))
+#define CHUNK_STAT_NOW() chunk_render_now_us()
+#define CHUNK_TRACE_BEGIN(system, name) \
+    do { if ((system)->traceBegin) (system)->traceBegin((name), (system)->traceUserData); } while (0)
+#define CHUNK_TRACE_END(system, name) \
+    do { if ((system)->traceEnd) (system)->traceEnd((name), (system)->traceUserData); } while (0)
+#else
+#define CHUNK_STAT_ADD(system, field, amount) ((void)sizeof(amount))
+#define CHUNK_STAT_NOW() ((uint64_t)0)
+#define CHUNK_TRACE_BEGIN(system, name) ((void)0)
+#define CHUNK_TRACE_END(system, name) ((void)0)
+#endif
+
+// Rectangle of tiles inside a chunk (chunk-local tile coordinates)
+typedef struct ChunkTileRegion {
+    int localX;
+    int localY;
+    int width;
+    int height;
+} ChunkTileRegion;
+
+// Internal per-chunk record
+// ChunkRenderData must stay the first member so values stored in
+// system->chunks can be used directly as ChunkRenderData*
+typedef struct ChunkSlot {
+    ChunkRenderData data;
+    IntCoord key;                // Table key, valid while the slot is resident
+    struct ChunkSlot* prev;      // Residency list, least -> most recently visible
+    struct ChunkSlot* next;      // Residency list, also the free-list link
+    
+    // Rebuild scheduling
+    uint64_t dirtyFrame;         // Frame the chunk was last marked dirty
+    int64_t priorityDistSq;      // Squared chunk distance to the nearest observer
+    bool queued;                 // In this frame's rebuild queue
+    
+    // Tile-level dirty tracking; data.isDirty still means "redraw everything"
+    ChunkTileRegion dirtyRegion; // Bounding box of changed tiles
+    bool hasDirtyRegion;
+    
+    ChunkTileRegion rebuildRegion;  // Region being rebuilt in the current batch
+    
+    // Lazily built reduced-resolution copies, index = level - 1
+    void* lodTextures[CHUNK_RENDER_MAX_LOD_LEVEL];
+    unsigned lodValid;           // Bit per level, cleared when the chunk is rebuilt
+    uint64_t fullResFrame;       // Last frame the full-resolution texture was drawn or rebuilt
+    bool lodOnly;                // Full-resolution target released while only LOD levels are drawn
+    
+    // Page packing
+    int pageCell;                // Cell in the page textures, if hasPageCell
+    bool hasPageCell;
+    bool pageValid;              // Cell holds the current chunk image
+    bool pageOnly;               // Own target released; the image lives in the page cell only
+    
+    // Hash of all tile ids, set by full rebuilds while dedup or the disk cache is on
+    uint64_t contentHash;
+    bool hasContentHash;
+    ChunkSharedTexture* sharedTexture;  // Registered texture this chunk uses, if any
+} ChunkSlot;
+
+// Allocate from the system arena, counting allocations and bytes
+void* chunk_arena_alloc(ChunkRenderSystem* system, size_t bytes, const char* file, int line);
+
+// Flag a chunk for a full redraw
+void chunk_mark_slot_dirty(ChunkRenderSystem* system, ChunkSlot* slot);
+
+// Grow the chunk's dirty box to include region (no-op while fully dirty)
+void chunk_mark_slot_region_dirty(ChunkRenderSystem* system, ChunkSlot* slot, const ChunkTileRegion* region);
+
+// Drop the batched tile-edit scratch (arena-owned)
+void chunk_dirty_batch_release(ChunkRenderSystem* system);
+
+// Close the previous frame's stats and start a new frame
+void chunk_stats_begin_frame(ChunkRenderSystem* system);
+
+// Monotonic clock in microseconds
+uint64_t chunk_render_now_us(void);
+
+// Fill the atlas lookup entry for tileId (slow path of chunk_atlas_rect)
+RenderRect chunk_atlas_rect_miss(ChunkRenderSystem* system, int tileId);
+
+// Atlas source rectangle for a tile id, served from the dense lookup table
+// Unfilled entries are marked with a negative width
+static inline RenderRect chunk_atlas_rect(ChunkRenderSystem* system, int tileId) {
+    if ((unsigned)tileId < system->atlasRectCapacity && system->atlasRects[tileId].width >= 0.0f) {
+        return system->atlasRects[tileId];
+    }
+    return chunk_atlas_rect_miss(system, tileId);
+}
+
+// Atlas lookup that never writes the table (safe on the prefetch worker
+// while it holds the atlas lock); misses go straight to the atlas
+RenderRect chunk_atlas_rect_shared(ChunkRenderSystem* system, int tileId);
+
+// Copy the tile ids of a chunk region into outTileIds (row-major, region width stride)
+// Uses the bulk row fetch when installed; empty cells get CHUNK_RENDER_EMPTY_TILE
+void chunk_gather_tile_ids(ChunkRenderSystem* system,
+                           int chunkX, int chunkY,
+                           const ChunkTileRegion* region,
+                           int* outTileIds);
+
+// Fill outQuads with one quad per non-empty tile id, walking the ids linearly
+// Returns the number of quads written (at most region width * height)
+// sharedAtlas selects chunk_atlas_rect_shared for use off the main thread
+size_t chunk_build_tile_quads(ChunkRenderSystem* system,
+                              const int* tileIds,
+                              const ChunkTileRegion* region,
+                              ChunkTileQuad* outQuads,
+                              bool sharedAtlas);
+
+// Submit quads to the active render texture (batched when supported)
+void chunk_submit_tile_quads(ChunkRenderSystem* system, const ChunkTileQuad* quads, size_t count);
+
+// Clear a chunk's render texture and draw prebuilt full-chunk quads into it
+void chunk_upload_tile_quads(ChunkRenderSystem* system, ChunkRenderData* chunk, const ChunkTileQuad* quads, size_t count);
+
+// Rebuild a chunk's render texture from the tilemap
+// Redraws only the dirty tile region when the chunk is loaded and not fully dirty
+void chunk_render_tiles(ChunkRenderSystem* system, ChunkRenderData* chunk);
+
+// The stages of chunk_render_tiles, split so geometry can be built on workers:
+// chunk_rebuild_region picks the region to redraw (false if the chunk cannot
+// be drawn), chunk_rebuild_from_prefetch uploads a prefetched result,
+// chunk_prepare_tiles builds quads (thread-safe with sharedAtlas),
+// chunk_rebuild_from_cache shares an identical chunk's texture or uploads a
+// stored image for the gathered tile ids, and chunk_finish_tiles uploads the
+// quads on the calling thread
+// Rebuilds that complete count towards chunksRebuilt; skipped ones do not
+bool chunk_rebuild_region(ChunkRenderSystem* system, ChunkRenderData* chunk, ChunkTileRegion* outRegion);
+bool chunk_rebuild_from_prefetch(ChunkRenderSystem* system, ChunkRenderData* chunk, const ChunkTileRegion* region);
+bool chunk_rebuild_from_cache(ChunkRenderSystem* system, ChunkRenderData* chunk, const ChunkTileRegion* region,
+                              const int* tileIds);
+size_t chunk_prepare_tiles(ChunkRenderSystem* system, ChunkRenderData* chunk, const ChunkTileRegion* region,
+                           int* tileIds, ChunkTileQuad* quads, bool sharedAtlas);
+void chunk_finish_tiles(ChunkRenderSystem* system, ChunkRenderData* chunk, const ChunkTileRegion* region,
+                        const int* tileIds, const ChunkTileQuad* quads, size_t count);
+
+// Full rebuilds are hashed for dedup and the disk cache while either is on
+bool chunk_rebuild_hashes(ChunkRenderSystem* system, const ChunkTileRegion* region);
+
+// Worker pool for parallel chunk geometry (threadCount includes the caller)
+// Returns NULL when fewer than two threads are requested or threads are unavailable
+ChunkJobPool* chunk_job_pool_create(int threadCount);
+void chunk_job_pool_destroy(ChunkJobPool* pool);
+int chunk_job_pool_thread_count(ChunkJobPool* pool);
+
+// ChunkRenderJobRunFn for an owned pool (userData is the ChunkJobPool)
+void chunk_job_pool_run(int jobCount, ChunkRenderJobFn job, void* context, void* userData);
+
+// Pop up to `limit` queued chunks (one batch), build their geometry through
+// system->jobRun and upload it; returns the number of chunks popped
+// Prefetch, dedup and disk cache hits are served before the batch is built
+int chunk_rebuild_batch(ChunkRenderSystem* system, int limit);
+
+// Stop the owned worker pool, if any
+void chunk_rebuild_jobs_release(ChunkRenderSystem* system);
+
+// Re-read entity observer positions and move them between chunk buckets
+void chunk_observers_poll(ChunkRenderSystem* system, ECS* ecs, ComponentTypeId positionTypeId);
+
+// Write the distinct observer chunks to out (observerBucketCount entries)
+size_t chunk_observers_collect_chunks(ChunkRenderSystem* system, IntCoord* out);
+
+// True the first time this frame a chunk's prefetch edge is scanned for a
+// heading, so observers sharing a chunk and direction scan it once
+bool chunk_observers_claim_edge(ChunkRenderSystem* system, IntCoord chunk, IntCoord heading);
+
+// Free the observer arrays, handle records and hash tables
+void chunk_observers_release(ChunkRenderSystem* system);
+
+// Refresh the merged observer coverage for the current frame
+// Spans are only rebuilt when a chunk gained its first or lost its last
+// observer, a viewport's chunk window changed, or the render radius changed
+void chunk_coverage_prepare(ChunkRenderSystem* system, ECS* ecs, ComponentTypeId positionTypeId);
+
+// Record the chunk window a viewport just drew; a changed window is merged
+// into the coverage from the next update
+void chunk_coverage_set_view(ChunkRenderSystem* system, ChunkRenderViewport* view, bool hasRect,
+                             int chunkMinX, int chunkMinY, int chunkMaxX, int chunkMaxY);
+
+// Force the next chunk_coverage_prepare to rebuild the spans
+void chunk_coverage_invalidate(ChunkRenderSystem* system);
+
+// Squared chunk distance to the nearest observer chunk
+int64_t chunk_coverage_nearest_dist_sq(ChunkRenderSystem* system, int chunkX, int chunkY);
+
+// Add a chunk to this frame's rebuild queue (no-op if already queued)
+void chunk_rebuild_queue_push(ChunkRenderSystem* system, ChunkSlot* slot);
+
+// Order the queue once all priorities for the frame are known
+void chunk_rebuild_queue_heapify(ChunkRenderSystem* system);
+
+// Remove the highest priority chunk (NULL when empty)
+ChunkSlot* chunk_rebuild_queue_pop(ChunkRenderSystem* system);
+
+// Drop remaining entries; they are gathered again next frame
+void chunk_rebuild_queue_clear(ChunkRenderSystem* system);
+
+// 64-bit hash of a chunk's tile ids
+uint64_t chunk_tile_hash(const int* tileIds, size_t count);
+
+// Upload the stored image for a chunk if its hash and atlas still match
+bool chunk_disk_cache_load(ChunkRenderSystem* system, ChunkRenderData* chunk, uint64_t contentHash);
+
+// Write a clean chunk's image unless the cache already holds it
+void chunk_disk_cache_store(ChunkRenderSystem* system, ChunkSlot* slot);
+
+// Queue an evicted chunk's image for writing (borrows its texture)
+void chunk_disk_cache_queue(ChunkRenderSystem* system, ChunkSlot* slot);
+
+// Write the oldest queued image; false when the queue is empty
+bool chunk_disk_cache_drain(ChunkRenderSystem* system);
+
+// Take over a released texture still queued for writing (true if taken)
+bool chunk_disk_cache_adopt(ChunkRenderSystem* system, void* renderTexture);
+
+// Write queued images of a texture about to be redrawn in place
+void chunk_disk_cache_settle(ChunkRenderSystem* system, void* renderTexture);
+
+// Bytes of evicted chunk textures owned by the write queue
+size_t chunk_disk_cache_pending_bytes(ChunkRenderSystem* system);
+
+// Use the registered texture of an identical chunk instead of drawing
+// (needs slot->contentHash); returns false when there is none
+bool chunk_dedup_share(ChunkRenderSystem* system, ChunkSlot* slot, const int* tileIds);
+
+// Register a fully drawn chunk's texture for sharing
+void chunk_dedup_register(ChunkRenderSystem* system, ChunkSlot* slot, const int* tileIds);
+
+// Stop sharing before the chunk is redrawn; returns true when the chunk
+// received a fresh (blank) render target
+bool chunk_dedup_detach(ChunkRenderSystem* system, ChunkSlot* slot);
+
+// Drop an evicted chunk's reference; returns true when other chunks still
+// use the texture, so it must not be released
+bool chunk_dedup_release(ChunkRenderSystem* system, ChunkSlot* slot);
+
+// Free the shared texture table (after all residents were released)
+void chunk_dedup_release_all(ChunkRenderSystem* system);
+
+// Bytes of render-target memory held by one chunk (RGBA8)
+size_t chunk_texture_bytes(ChunkRenderSystem* system);
+
+// Render-target bytes of all resident chunks, counting shared textures once,
+// plus their LOD textures and the page textures
+size_t chunk_resident_texture_bytes(ChunkRenderSystem* system);
+
+// Take a chunk render target from the pool, creating one on a miss
+void* chunk_render_target_acquire(ChunkRenderSystem* system);
+
+// Return a chunk render target to the pool (destroyed if the pool is full)
+void chunk_render_target_release(ChunkRenderSystem* system, void* renderTexture);
+
+// Destroy every pooled render target
+void chunk_render_target_pool_release_all(ChunkRenderSystem* system);
+
+// Upload the worker-built quads for a chunk if a current result is ready
+// Returns false (and drops any outdated job) when the chunk must be rebuilt
+bool chunk_prefetch_upload(ChunkRenderSystem* system, ChunkRenderData* chunk);
+
+// Drop any queued or finished prefetch job for a chunk whose tiles changed
+void chunk_prefetch_invalidate(ChunkRenderSystem* system, int chunkX, int chunkY);
+
+// Queue ring chunks ahead of moving observers for the worker
+void chunk_prefetch_schedule(ChunkRenderSystem* system);
+
+// Drop prefetch jobs for chunks the predicate reports as changed
+typedef bool (*ChunkPrefetchDirtyFn)(void* userData, int chunkX, int chunkY);
+void chunk_prefetch_discard_if(ChunkRenderSystem* system, ChunkPrefetchDirtyFn isDirty, void* userData);
+
+// Serialize atlas table writes against the prefetch worker (no-op when off)
+void chunk_prefetch_lock_atlas(ChunkRenderSystem* system);
+void chunk_prefetch_unlock_atlas(ChunkRenderSystem* system);
+
+// Pick a view's LOD level for camera zoom * aspect-fit scale, with
+// hysteresis around its current level
+int chunk_lod_select(ChunkRenderSystem* system, int current, float effectiveScale);
+
+// Downsample chunks in coverage that lack a texture for a level some view
+// draws, and release the full-resolution target of chunks only drawn at
+// LOD levels for a while
+void chunk_lod_update(ChunkRenderSystem* system);
+
+// True for an LOD-only chunk that needs its full-resolution image redrawn
+// (a view draws level 0, or a level in use has no finer image to come from)
+bool chunk_lod_needs_full(ChunkRenderSystem* system, ChunkSlot* slot);
+
+// Texture to draw for a chunk at a level (full resolution if not built yet,
+// the finest LOD texture while an LOD-only chunk waits for its rebuild)
+void* chunk_lod_texture(ChunkRenderSystem* system, ChunkSlot* slot, int level, float* outPixelSize);
+
+// Destroy a chunk's LOD textures
+void chunk_lod_release(ChunkRenderSystem* system, ChunkSlot* slot);
+
+// Copy covered chunks whose page cell is missing or outdated into their pages
+void chunk_page_update(ChunkRenderSystem* system);
+
+// Queue a chunk for the paged draw (false if it has no current page image)
+bool chunk_page_queue(ChunkRenderSystem* system, ChunkSlot* slot, RenderRect dstRect);
+
+// Submit queued chunks, one batch per page
+void chunk_page_flush(ChunkRenderSystem* system);
+
+// Return a chunk's page cell to the free list
+void chunk_page_release(ChunkRenderSystem* system, ChunkSlot* slot);
+
+// Destroy every page texture
+void chunk_page_release_all(ChunkRenderSystem* system);
+
+// Bytes of render-target memory held by page textures
+size_t chunk_page_bytes(ChunkRenderSystem* system);
+
+// Direct mode needs tile data and an atlas to draw from
+bool chunk_direct_available(ChunkRenderSystem* system);
+
+// Build screen-space quads for a chunk region and append them to the frame's batch
+void chunk_direct_queue(ChunkRenderSystem* system, int chunkX, int chunkY, const ChunkTileRegion* region,
+                        RenderVector2 chunkScreenPos, float pixelScale);
+
+// Submit the frame's direct quads as one batch
+void chunk_direct_flush(ChunkRenderSystem* system);
+
+// Count tiles marked dirty (feeds the auto mode's dirty rate)
+void chunk_direct_note_dirty(ChunkRenderSystem* system, size_t tiles);
+
+// Fold this update's dirty tiles into the smoothed dirty rate
+void chunk_direct_end_update(ChunkRenderSystem* system);
+
+// Record the visible tile count and pick the next frame's path in auto mode
+void chunk_direct_select_mode(ChunkRenderSystem* system, size_t visibleTiles);
+
+// Take a slot from the free list, or allocate a new one from the arena
+ChunkSlot* chunk_slot_acquire(ChunkRenderSystem* system);
+
+// Append a newly created slot to the residency list (most recently visible)
+void chunk_residency_insert(ChunkRenderSystem* system, ChunkSlot* slot);
+
+// Mark a resident chunk as visible this frame and move it to the MRU end
+void chunk_residency_touch(ChunkRenderSystem* system, ChunkSlot* slot);
+
+// Evict least recently visible chunks until the system is within budget
+// Chunks visible in the current frame are never evicted
+void chunk_residency_enforce_budget(ChunkRenderSystem* system);
+
+// Release every resident chunk (render textures and table entries)
+void chunk_residency_release_all(ChunkRenderSystem* system);
+
+#endif // CHUNK_RENDER_INTERNAL_H
@@ -0,0 +1,89 @@
+#include "chunk_render_internal.h"
+#include <string.h>
+
+void chunk_stats_begin_frame(ChunkRenderSystem* system) {
+#if GRAMARYE_CHUNK_RENDERER_STATS
+    if (system->currentFrame > 1) {
+        system->statsHistory[system->statsHistoryNext] = system->statsCurrent;
+        system->statsHistoryNext = (system->statsHistoryNext + 1) % CHUNK_RENDER_STATS_WINDOW;
+        if (system->statsHistoryCount < CHUNK_RENDER_STATS_WINDOW) {
+            system->statsHistoryCount++;
+        }
+    }
+    memset(&system->statsCurrent, 0, sizeof(ChunkRenderFrameStats));
+#else
+    (void)system;
+#endif
+}
+
+#if GRAMARYE_CHUNK_RENDERER_STATS
+static void accumulate(ChunkRenderFrameStats* sum, ChunkRenderFrameStats* peak, const ChunkRenderFrameStats* frame) {
+    sum->chunksRebuilt += frame->chunksRebuilt;
+    sum->tilesEmitted += frame->tilesEmitted;
+    sum->drawCommands += frame->drawCommands;
+    sum->prefetchUploads += frame->prefetchUploads;
+    sum->diskCacheLoads += frame->diskCacheLoads;
+    sum->diskCacheStores += frame->diskCacheStores;
+    sum->dedupHits += frame->dedupHits;
+    sum->updateMicros += frame->updateMicros;
+    sum->renderMicros += frame->renderMicros;
+    
+    if (frame->chunksRebuilt > peak->chunksRebuilt) peak->chunksRebuilt = frame->chunksRebuilt;
+    if (frame->tilesEmitted > peak->tilesEmitted) peak->tilesEmitted = frame->tilesEmitted;
+    if (frame->drawCommands > peak->drawCommands) peak->drawCommands = frame->drawCommands;
+    if (frame->prefetchUploads > peak->prefetchUploads) peak->prefetchUploads = frame->prefetchUploads;
+    if (frame->diskCacheLoads > peak->diskCacheLoads) peak->diskCacheLoads = frame->diskCacheLoads;
+    if (frame->diskCacheStores > peak->diskCacheStores) peak->diskCacheStores = frame->diskCacheStores;
+    if (frame->dedupHits > peak->dedupHits) peak->dedupHits = frame->dedupHits;
+    if (frame->updateMicros > peak->updateMicros) peak->updateMicros = frame->updateMicros;
+    if (frame->renderMicros > peak->renderMicros) peak->renderMicros = frame->renderMicros;
+}
+#endif
+
+ChunkRenderStats ChunkRenderSystem_get_stats(ChunkRenderSystem* system) {
+    ChunkRenderStats stats;
+    memset(&stats, 0, sizeof(ChunkRenderStats));
+    if (!system) return stats;
+    
+    stats.frameNumber = system->currentFrame;
+    stats.residentChunks = system->residentCount;
+    stats.renderTargetBytes = chunk_resident_texture_bytes(system) + chunk_disk_cache_pending_bytes(system);
+    stats.observerCount = system->observerCount;
+    stats.rebuildQueueDepth = system->rebuildQueueDepth;
+    
+#if GRAMARYE_CHUNK_RENDERER_STATS
+    stats.frame = system->statsCurrent;
+    
+    ChunkRenderFrameStats sum;
+    memset(&sum, 0, sizeof(ChunkRenderFrameStats));
+    for (size_t i = 0; i < system->statsHistoryCount; i++) {
+        accumulate(&sum, &stats.peak, &system->statsHistory[i]);
+    }
+    
+    size_t frames = system->statsHistoryCount;
+    stats.windowFrames = frames;
+    if (frames > 0) {
+        stats.average.chunksRebuilt = (double)sum.chunksRebuilt / (double)frames;
+        stats.average.tilesEmitted = (double)sum.tilesEmitted / (double)frames;
+        stats.average.drawCommands = (double)sum.drawCommands / (double)frames;
+        stats.average.prefetchUploads = (double)sum.prefetchUploads / (double)frames;
+        stats.average.diskCacheLoads = (double)sum.diskCacheLoads / (double)frames;
+        stats.average.diskCacheStores = (double)sum.diskCacheStores / (double)frames;
+        stats.average.dedupHits = (double)sum.dedupHits / (double)frames;
+        stats.average.updateMicros = (double)sum.updateMicros / (double)frames;
+        stats.average.renderMicros = (double)sum.renderMicros / (double)frames;
+    }
+#endif
+    
+    return stats;
+}
+
+void ChunkRenderSystem_set_trace_hooks(ChunkRenderSystem* system,
+                                       ChunkRenderTraceFn begin,
+                                       ChunkRenderTraceFn end,
+                                       void* userData) {
+    if (!system) return;
+    system->traceBegin = begin;
+    system->traceEnd = end;
+    system->traceUserData = userData;
+}
@@ -1,4 +1,5 @@
 #include "gramarye_chunk_renderer/chunk_render_system.h"
+#include "chunk_render_internal.h"
 #include "core/position.h"
 #include "textures/atlas.h"
 #include "tilemap/tilemap.h"
@@ -10,6 +11,7 @@
         #define HAS_CHUNK_MANAGER 1
     #endif
 #endif
+#include <limits.h>
 #include <math.h>
 #include <string.h>
 
@@ -23,25 +25,11 @@ static inline void ChunkManagerSystem_clear_dirty(ChunkManagerSystem* system) {
 }
 #endif
 
-static RenderRect rect_from_raylib_rectangle(Rectangle r) {
-    RenderRect result;
-    result.x = r.x;
-    result.y = r.y;
-    result.width = r.width;
-    result.height = r.height;
-    return result;
-}
-
 static RenderColor color_white(void) {
     RenderColor c = {255, 255, 255, 255};
     return c;
 }
 
-static RenderColor color_black(void) {
-    RenderColor c = {0, 0, 0, 255};
-    return c;
-}
-
 static void get_chunk_coord(ChunkRenderSystem* system, int tileX, int tileY, int* outChunkX, int* outChunkY) {
     if (tileX >= 0) {
         *outChunkX = tileX / system->chunkSize;
@@ -67,102 +55,136 @@ static ChunkRenderData* get_or_create_chunk(ChunkRenderSystem* system, int chunk
     ChunkRenderData* chunk = (ChunkRenderData*)Table_get(system->chunks, &coord);
     
     if (!chunk) {
-        chunk = (ChunkRenderData*)Arena_alloc(system->arena, sizeof(ChunkRenderData), __FILE__, __LINE__);
+        ChunkSlot* slot = chunk_slot_acquire(system);
+        chunk = &slot->data;
         chunk->chunkX = chunkX;
         chunk->chunkY = chunkY;
         chunk->isDirty = true;
         chunk->isLoaded = false;
         chunk->lastUpdateFrame = 0;
+        slot->dirtyFrame = system->currentFrame;
         
-        int chunkPixelSize = system->chunkSize * system->tileSize;
-        if (system->renderer) {
-            chunk->renderTexture = Renderer_create_render_texture(system->renderer, chunkPixelSize, chunkPixelSize);
-        } else {
-            chunk->renderTexture = NULL;
-        }
+        chunk->renderTexture = chunk_render_target_acquire(system);
         
-        IntCoord* key = (IntCoord*)Arena_alloc(system->arena, sizeof(IntCoord), __FILE__, __LINE__);
-        key->x = chunkX;
-        key->y = chunkY;
-        Table_put(system->chunks, key, chunk);
+        slot->key.x = chunkX;
+        slot->key.y = chunkY;
+        Table_put(system->chunks, &slot->key, chunk);
+        chunk_residency_insert(system, slot);
     }
     
     return chunk;
 }
 
-static void render_chunk_tiles(ChunkRenderSystem* system, ChunkRenderData* chunk) {
-    if (!chunk || !system->tilemap || !system->atlas || !system->renderer || !chunk->renderTexture) return;
+void* chunk_arena_alloc(ChunkRenderSystem* system, size_t bytes, const char* file, int line) {
+    system->arenaAllocations++;
+    system->arenaBytes += bytes;
+    return Arena_alloc(system->arena, (long)bytes, file, line);
+}
+
+void chunk_mark_slot_dirty(ChunkRenderSystem* system, ChunkSlot* slot) {
+    if (!slot->data.isDirty) {
+        slot->data.isDirty = true;
+        slot->dirtyFrame = system->currentFrame;
+    }
+}
+
+void chunk_mark_slot_region_dirty(ChunkRenderSystem* system, ChunkSlot* slot, const ChunkTileRegion* region) {
+    if (slot->data.isDirty) return;
     
-    Renderer_begin_render_texture(system->renderer, chunk->renderTexture);
+    if (!slot->hasDirtyRegion) {
+        slot->dirtyRegion = *region;
+        slot->hasDirtyRegion = true;
+    } else {
+        ChunkTileRegion* r = &slot->dirtyRegion;
+        int maxX = r->localX + r->width - 1;
+        int maxY = r->localY + r->height - 1;
+        int regionMaxX = region->localX + region->width - 1;
+        int regionMaxY = region->localY + region->height - 1;
+        if (region->localX < r->localX) r->localX = region->localX;
+        if (region->localY < r->localY) r->localY = region->localY;
+        if (regionMaxX > maxX) maxX = regionMaxX;
+        if (regionMaxY > maxY) maxY = regionMaxY;
+        r->width = maxX - r->localX + 1;
+        r->height = maxY - r->localY + 1;
+    }
+    slot->dirtyFrame = system->currentFrame;
+}
+
+#ifdef HAS_CHUNK_MANAGER
+static bool manager_chunk_dirty(void* userData, int chunkX, int chunkY) {
+    return ChunkManagerSystem_is_chunk_dirty((ChunkManagerSystem*)userData, chunkX, chunkY);
+}
+#endif
+
+static bool rebuild_budget_spent(ChunkRenderSystem* system, int done, uint64_t startMicros) {
+    if (system->maxRebuildsPerFrame > 0 && done >= system->maxRebuildsPerFrame) {
+        return true;
+    }
+    return system->maxRebuildMicros > 0 && done > 0 &&
+           chunk_render_now_us() - startMicros >= system->maxRebuildMicros;
+}
+
+// With a time budget, a worker batch takes only as many chunks as the
+// measured per-chunk cost fits in the time left (at least one, like the
+// serial path). Until a cost is measured, batches hold a single chunk
+static int budget_batch_limit(ChunkRenderSystem* system, int limit, uint64_t startMicros) {
+    if (system->maxRebuildMicros == 0) return limit;
+    if (system->rebuildChunkMicros <= 0.0f) return 1;
     
-    int chunkPixelSize = system->chunkSize * system->tileSize;
-    RenderCommand clearCmd = {
-        .type = RENDER_COMMAND_TYPE_RECTANGLE,
-        .bounds = {0, 0, (float)chunkPixelSize, (float)chunkPixelSize},
-        .color = color_black()
-    };
-    Renderer_execute_command(system->renderer, &clearCmd);
+    uint64_t elapsed = chunk_render_now_us() - startMicros;
+    uint64_t left = elapsed < system->maxRebuildMicros ? system->maxRebuildMicros - elapsed : 0;
+    double fit = (double)left / (double)system->rebuildChunkMicros;
+    if (fit < 1.0) return 1;
+    return fit < (double)limit ? (int)fit : limit;
+}
+
+// Smoothed over batches, as cache hits and partial rebuilds vary the cost
+static void note_batch_cost(ChunkRenderSystem* system, int chunks, uint64_t micros) {
+    float sample = (float)micros / (float)chunks;
+    if (system->rebuildChunkMicros <= 0.0f) {
+        system->rebuildChunkMicros = sample;
+    } else {
+        system->rebuildChunkMicros = system->rebuildChunkMicros * 0.75f + sample * 0.25f;
+    }
+}
+
+// Disk cache writes of evicted chunks share what the rebuilds left of the budget
+static void drain_disk_cache(ChunkRenderSystem* system, int done, uint64_t startMicros) {
+    while (!rebuild_budget_spent(system, done, startMicros) && chunk_disk_cache_drain(system)) {
+        done++;
+    }
+}
+
+static void process_rebuild_queue(ChunkRenderSystem* system) {
+    chunk_rebuild_queue_heapify(system);
     
-    int startTileX = chunk->chunkX * system->chunkSize;
-    int startTileY = chunk->chunkY * system->chunkSize;
+    uint64_t startMicros = system->maxRebuildMicros > 0 ? chunk_render_now_us() : 0;
+    int rebuilt = 0;
     
-    for (int localY = 0; localY < system->chunkSize; localY++) {
-        for (int localX = 0; localX < system->chunkSize; localX++) {
-            int tileX = startTileX + localX;
-            int tileY = startTileY + localY;
-            
-            Tile* tile = Tilemap_get_tile(system->tilemap, tileX, tileY);
-            if (tile) {
-                Rectangle sourceRectRaylib = Atlas_getRect(system->atlas, tile->tile_id);
-                RenderRect sourceRect = rect_from_raylib_rectangle(sourceRectRaylib);
-                
-                RenderRect destRect = {
-                    (float)(localX * system->tileSize),
-                    (float)(localY * system->tileSize),
-                    (float)system->tileSize,
-                    (float)system->tileSize
-                };
-                
-                RenderCommand texCmd = {
-                    .type = RENDER_COMMAND_TYPE_TEXTURE,
-                    .bounds = destRect,
-                    .color = color_white(),
-                    .data.texture = {
-                        .textureHandle = &system->atlas->texture,
-                        .srcRect = sourceRect,
-                        .rotation = 0.0f,
-                        .origin = {0, 0}
-                    }
-                };
-                Renderer_execute_command(system->renderer, &texCmd);
+    while (system->rebuildQueueCount > 0) {
+        if (rebuild_budget_spent(system, rebuilt, startMicros)) break;
+        
+        if (system->jobRun) {
+            int limit = system->maxRebuildsPerFrame > 0 ? system->maxRebuildsPerFrame - rebuilt : INT_MAX;
+            limit = budget_batch_limit(system, limit, startMicros);
+            uint64_t batchStart = system->maxRebuildMicros > 0 ? chunk_render_now_us() : 0;
+            int popped = chunk_rebuild_batch(system, limit);
+            if (system->maxRebuildMicros > 0 && popped > 0) {
+                note_batch_cost(system, popped, chunk_render_now_us() - batchStart);
             }
+            rebuilt += popped;
+            continue;
         }
+        
+        ChunkSlot* slot = chunk_rebuild_queue_pop(system);
+        chunk_render_tiles(system, &slot->data);
+        slot->data.isDirty = false;
+        rebuilt++;
     }
     
-    Renderer_end_render_texture(system->renderer);
-    chunk->isDirty = false;
-    chunk->isLoaded = true;
-    chunk->lastUpdateFrame = system->currentFrame;
-}
-
-static void get_observer_tile_pos(ChunkRenderSystem* system, 
-                                   Observer* observer,
-                                   ECS* ecs,
-                                   ComponentTypeId positionTypeId,
-                                   int* outTileX, int* outTileY) {
-    if (observer->type == OBSERVER_ENTITY) {
-        Position* pos = Position_get(ecs, observer->data.entityId, positionTypeId);
-        if (pos) {
-            *outTileX = pos->x;
-            *outTileY = pos->y;
-        } else {
-            *outTileX = 0;
-            *outTileY = 0;
-        }
-    } else {
-        *outTileX = observer->data.manual.tileX;
-        *outTileY = observer->data.manual.tileY;
-    }
+    system->rebuildQueueDepth = system->rebuildQueueCount;
+    chunk_rebuild_queue_clear(system);
+    drain_disk_cache(system, rebuilt, startMicros);
 }
 
 void ChunkRenderSystem_init(ChunkRenderSystem* system,
@@ -179,87 +201,84 @@ void ChunkRenderSystem_init(ChunkRenderSystem* system,
     system->tilemap = tilemap;
     system->atlas = atlas;
     system->renderer = renderer;
+    system->backend = ChunkRenderBackend_renderer();
+    system->backendContext = renderer;
     system->tileSize = tileSize;
     system->chunkSize = chunkSize;
     system->renderRadius = renderRadius;
     system->simulationRadius = simulationRadius;
     system->chunks = Table_new(256, IntCoord_cmp, IntCoord_hash);
-    system->observerCapacity = 16;
-    system->observers = (Observer*)Arena_alloc(arena, sizeof(Observer) * system->observerCapacity, __FILE__, __LINE__);
-    system->observerCount = 0;
     system->currentFrame = 0;
+    system->tileIds = (int*)chunk_arena_alloc(system, sizeof(int) * (size_t)chunkSize * (size_t)chunkSize, __FILE__, __LINE__);
+    system->tileQuads = (ChunkTileQuad*)chunk_arena_alloc(system, sizeof(ChunkTileQuad) * (size_t)chunkSize * (size_t)chunkSize, __FILE__, __LINE__);
+    ChunkRenderSystem_configure_render_target_pool(system, 32, 0);
 }
 
-void ChunkRenderSystem_add_entity_observer(ChunkRenderSystem* system,
-                                           ECS* ecs,
-                                           EntityId entity,
-                                           ComponentTypeId positionTypeId) {
-    for (size_t i = 0; i < system->observerCount; i++) {
-        if (system->observers[i].type == OBSERVER_ENTITY && 
-            system->observers[i].data.entityId.high == entity.high &&
-            system->observers[i].data.entityId.low == entity.low) {
-            return;
-        }
-    }
+static void update_cached(ChunkRenderSystem* system, ChunkManagerSystem* chunkManager) {
+    size_t chunkTiles = (size_t)system->chunkSize * (size_t)system->chunkSize;
     
-    if (system->observerCount >= system->observerCapacity) {
-        size_t newCapacity = system->observerCapacity * 2;
-        Observer* newObservers = (Observer*)Arena_alloc(system->arena, sizeof(Observer) * newCapacity, __FILE__, __LINE__);
-        memcpy(newObservers, system->observers, sizeof(Observer) * system->observerCount);
-        system->observers = newObservers;
-        system->observerCapacity = newCapacity;
-    }
-    
-    system->observers[system->observerCount].type = OBSERVER_ENTITY;
-    system->observers[system->observerCount].data.entityId = entity;
-    system->observerCount++;
-}
-
-void ChunkRenderSystem_add_manual_observer(ChunkRenderSystem* system, int tileX, int tileY) {
-    for (size_t i = 0; i < system->observerCount; i++) {
-        if (system->observers[i].type == OBSERVER_MANUAL &&
-            system->observers[i].data.manual.tileX == tileX &&
-            system->observers[i].data.manual.tileY == tileY) {
-            return;
+    for (size_t i = 0; i < system->coverageSpanCount; i++) {
+        const ChunkSpan* span = &system->coverageSpans[i];
+        int chunkY = span->chunkY;
+        
+        for (int chunkX = span->minChunkX; chunkX <= span->maxChunkX; chunkX++) {
+            ChunkRenderData* chunk = get_or_create_chunk(system, chunkX, chunkY);
+            ChunkSlot* slot = (ChunkSlot*)chunk;
+            chunk_residency_touch(system, slot);
+            
+#ifdef HAS_CHUNK_MANAGER
+            // Manager flags are cleared at the end of this update, so
+            // keep them locally until the chunk is actually rebuilt
+            if (chunkManager && ChunkManagerSystem_is_chunk_dirty(chunkManager, chunkX, chunkY)) {
+                chunk_mark_slot_dirty(system, slot);
+                chunk_direct_note_dirty(system, chunkTiles);
+            }
+#else
+            (void)chunkTiles;
+#endif
+            
+            if (!chunk->isLoaded || chunk->isDirty || slot->hasDirtyRegion || chunk_lod_needs_full(system, slot)) {
+                slot->priorityDistSq = chunk_coverage_nearest_dist_sq(system, chunkX, chunkY);
+                chunk_rebuild_queue_push(system, slot);
+            }
         }
     }
     
-    if (system->observerCount >= system->observerCapacity) {
-        size_t newCapacity = system->observerCapacity * 2;
-        Observer* newObservers = (Observer*)Arena_alloc(system->arena, sizeof(Observer) * newCapacity, __FILE__, __LINE__);
-        memcpy(newObservers, system->observers, sizeof(Observer) * system->observerCount);
-        system->observers = newObservers;
-        system->observerCapacity = newCapacity;
-    }
+    CHUNK_TRACE_BEGIN(system, "chunk_rebuild");
+    process_rebuild_queue(system);
+    CHUNK_TRACE_END(system, "chunk_rebuild");
     
-    system->observers[system->observerCount].type = OBSERVER_MANUAL;
-    system->observers[system->observerCount].data.manual.tileX = tileX;
-    system->observers[system->observerCount].data.manual.tileY = tileY;
-    system->observerCount++;
-}
-
-void ChunkRenderSystem_remove_entity_observer(ChunkRenderSystem* system, EntityId entity) {
-    for (size_t i = 0; i < system->observerCount; i++) {
-        if (system->observers[i].type == OBSERVER_ENTITY &&
-            system->observers[i].data.entityId.high == entity.high &&
-            system->observers[i].data.entityId.low == entity.low) {
-            system->observers[i] = system->observers[system->observerCount - 1];
-            system->observerCount--;
-            return;
-        }
+    chunk_page_update(system);
+    chunk_lod_update(system);
+    chunk_residency_enforce_budget(system);
+    
+#ifdef HAS_CHUNK_MANAGER
+    if (chunkManager) {
+        chunk_prefetch_discard_if(system, manager_chunk_dirty, chunkManager);
     }
+#endif
+    chunk_prefetch_schedule(system);
 }
 
-void ChunkRenderSystem_remove_manual_observer(ChunkRenderSystem* system, int tileX, int tileY) {
-    for (size_t i = 0; i < system->observerCount; i++) {
-        if (system->observers[i].type == OBSERVER_MANUAL &&
-            system->observers[i].data.manual.tileX == tileX &&
-            system->observers[i].data.manual.tileY == tileY) {
-            system->observers[i] = system->observers[system->observerCount - 1];
-            system->observerCount--;
-            return;
+// Tiles are drawn straight from the tilemap, so there is nothing to rebuild;
+// chunks still cached from auto mode only need to keep their dirty state
+static void update_direct(ChunkRenderSystem* system, ChunkManagerSystem* chunkManager) {
+#ifdef HAS_CHUNK_MANAGER
+    if (chunkManager) {
+        size_t chunkTiles = (size_t)system->chunkSize * (size_t)system->chunkSize;
+        for (ChunkSlot* slot = system->residentHead; slot; slot = slot->next) {
+            if (ChunkManagerSystem_is_chunk_dirty(chunkManager, slot->data.chunkX, slot->data.chunkY)) {
+                chunk_mark_slot_dirty(system, slot);
+                chunk_direct_note_dirty(system, chunkTiles);
+            }
         }
+        chunk_prefetch_discard_if(system, manager_chunk_dirty, chunkManager);
     }
+#else
+    (void)chunkManager;
+#endif
+    drain_disk_cache(system, 0, system->maxRebuildMicros > 0 ? chunk_render_now_us() : 0);
+    chunk_residency_enforce_budget(system);
 }
 
 void ChunkRenderSystem_update(ChunkRenderSystem* system,
@@ -267,52 +286,190 @@ void ChunkRenderSystem_update(ChunkRenderSystem* system,
                                ComponentTypeId positionTypeId,
                                ChunkManagerSystem* chunkManager) {
     system->currentFrame++;
+    chunk_stats_begin_frame(system);
+    uint64_t startMicros = CHUNK_STAT_NOW();
+    CHUNK_TRACE_BEGIN(system, "ChunkRenderSystem_update");
+    
+    CHUNK_TRACE_BEGIN(system, "chunk_coverage");
+    chunk_coverage_prepare(system, ecs, positionTypeId);
+    CHUNK_TRACE_END(system, "chunk_coverage");
+    
+    if (system->frameRendered) {
+        chunk_direct_select_mode(system, system->frameVisibleTiles);
+        system->frameVisibleTiles = 0;
+        system->frameRendered = false;
+    }
+    if (system->activeRenderMode == CHUNK_RENDER_MODE_DIRECT) {
+        update_direct(system, chunkManager);
+    } else {
+        update_cached(system, chunkManager);
+    }
+    chunk_direct_end_update(system);
     
-    for (size_t i = 0; i < system->observerCount; i++) {
-        int observerTileX, observerTileY;
-        get_observer_tile_pos(system, &system->observers[i], ecs, positionTypeId, &observerTileX, &observerTileY);
-        
-        int observerChunkX, observerChunkY;
-        get_chunk_coord(system, observerTileX, observerTileY, &observerChunkX, &observerChunkY);
-        
-        for (int dy = -system->renderRadius; dy <= system->renderRadius; dy++) {
-            for (int dx = -system->renderRadius; dx <= system->renderRadius; dx++) {
-                int chunkX = observerChunkX + dx;
-                int chunkY = observerChunkY + dy;
-                
-                float dist = sqrtf((float)(dx * dx + dy * dy));
-                if (dist <= (float)system->renderRadius) {
-                    ChunkRenderData* chunk = get_or_create_chunk(system, chunkX, chunkY);
-                    
-                    bool needsRender = !chunk->isLoaded;
-                    
 #ifdef HAS_CHUNK_MANAGER
-                    if (chunkManager) {
-                        if (ChunkManagerSystem_is_chunk_dirty(chunkManager, chunkX, chunkY)) {
-                            needsRender = true;
-                        }
-                    } else
+    if (chunkManager) {
+        ChunkManagerSystem_clear_dirty(chunkManager);
+    }
 #endif
-                    {
-                        if (chunk->isDirty) {
-                            needsRender = true;
+    
+    CHUNK_TRACE_END(system, "ChunkRenderSystem_update");
+    CHUNK_STAT_ADD(system, updateMicros, CHUNK_STAT_NOW() - startMicros);
+}
+
+// Compute the tile window covered by a width x height view in world space
+// Returns false (window untouched) when the view has no size
+static bool get_visible_tile_window(ChunkRenderSystem* system,
+                                    CameraHandle camera,
+                                    AspectFitHandle aspectFit,
+                                    float width, float height,
+                                    int* outMinX, int* outMinY,
+                                    int* outMaxX, int* outMaxY) {
+    if (width <= 0 || height <= 0) return false;
+    
+    RenderVector2 corners[4] = {
+        {0.0f, 0.0f},
+        {width, 0.0f},
+        {0.0f, height},
+        {width, height}
+    };
+    
+    float minX = 0.0f, minY = 0.0f, maxX = 0.0f, maxY = 0.0f;
+    for (int i = 0; i < 4; i++) {
+        RenderVector2 world = system->backend->screen_to_world(system->backendContext, camera, aspectFit, corners[i]);
+        if (i == 0 || world.x < minX) minX = world.x;
+        if (i == 0 || world.y < minY) minY = world.y;
+        if (i == 0 || world.x > maxX) maxX = world.x;
+        if (i == 0 || world.y > maxY) maxY = world.y;
+    }
+    
+    float tileSize = (float)system->tileSize;
+    *outMinX = (int)floorf(minX / tileSize);
+    *outMinY = (int)floorf(minY / tileSize);
+    *outMaxX = (int)floorf(maxX / tileSize);
+    *outMaxY = (int)floorf(maxY / tileSize);
+    return true;
+}
+
+// Draw the chunks inside one view; the view's LOD level is updated in place
+// Extra viewports (view != NULL) also hand their chunk window to the coverage
+static void render_view(ChunkRenderSystem* system,
+                        ECS* ecs,
+                        ComponentTypeId positionTypeId,
+                        CameraHandle camera,
+                        AspectFitHandle aspectFit,
+                        float viewWidth, float viewHeight,
+                        int* viewLodLevel,
+                        ChunkRenderViewport* view) {
+    // Tile window overlapping the camera view (unbounded if the view has no size)
+    int viewMinX = 0, viewMinY = 0, viewMaxX = 0, viewMaxY = 0;
+    bool hasView = get_visible_tile_window(system, camera, aspectFit, viewWidth, viewHeight,
+                                           &viewMinX, &viewMinY, &viewMaxX, &viewMaxY);
+    int chunkMinX = INT_MIN, chunkMinY = INT_MIN, chunkMaxX = INT_MAX, chunkMaxY = INT_MAX;
+    if (hasView) {
+        get_chunk_coord(system, viewMinX, viewMinY, &chunkMinX, &chunkMinY);
+        get_chunk_coord(system, viewMaxX, viewMaxY, &chunkMaxX, &chunkMaxY);
+    }
+    
+    chunk_coverage_prepare(system, ecs, positionTypeId);
+    if (view) {
+        chunk_coverage_set_view(system, view, hasView, chunkMinX, chunkMinY, chunkMaxX, chunkMaxY);
+    }
+    
+    // Camera scale is the same for every chunk
+    float zoom = system->backend->get_camera_zoom(system->backendContext, camera);
+    float scale = system->backend->get_aspect_fit_scale(system->backendContext, aspectFit);
+    int lodLevel = chunk_lod_select(system, *viewLodLevel, zoom * scale);
+    *viewLodLevel = lodLevel;
+    float chunkPixelSize = (float)(system->chunkSize * system->tileSize);
+    bool direct = system->activeRenderMode == CHUNK_RENDER_MODE_DIRECT && chunk_direct_available(system);
+    bool paged = !direct && system->pageChunks > 0 && lodLevel == 0;
+    // After auto switches back to cached, chunks still waiting for their
+    // first rebuild are drawn directly instead of leaving holes
+    bool fillGaps = system->renderMode == CHUNK_RENDER_MODE_AUTO && chunk_direct_available(system);
+    size_t visibleTiles = 0;
+    
+    // Coverage spans are disjoint, so every chunk is visited at most once
+    for (size_t i = 0; i < system->coverageSpanCount; i++) {
+        const ChunkSpan* span = &system->coverageSpans[i];
+        int chunkY = span->chunkY;
+        if (chunkY < chunkMinY || chunkY > chunkMaxY) continue;
+        
+        int minChunkX = span->minChunkX > chunkMinX ? span->minChunkX : chunkMinX;
+        int maxChunkX = span->maxChunkX < chunkMaxX ? span->maxChunkX : chunkMaxX;
+        for (int chunkX = minChunkX; chunkX <= maxChunkX; chunkX++) {
+            // Part of the chunk inside the view, in chunk-local tiles
+            ChunkTileRegion region = {0, 0, system->chunkSize, system->chunkSize};
+            if (hasView) {
+                int originX = chunkX * system->chunkSize;
+                int originY = chunkY * system->chunkSize;
+                int minX = viewMinX > originX ? viewMinX - originX : 0;
+                int minY = viewMinY > originY ? viewMinY - originY : 0;
+                int maxX = viewMaxX - originX < system->chunkSize - 1 ? viewMaxX - originX : system->chunkSize - 1;
+                int maxY = viewMaxY - originY < system->chunkSize - 1 ? viewMaxY - originY : system->chunkSize - 1;
+                region.localX = minX;
+                region.localY = minY;
+                region.width = maxX - minX + 1;
+                region.height = maxY - minY + 1;
+            }
+            visibleTiles += (size_t)region.width * (size_t)region.height;
+            
+            float chunkWorldX = (float)(chunkX * system->chunkSize * system->tileSize);
+            float chunkWorldY = (float)(chunkY * system->chunkSize * system->tileSize);
+            RenderVector2 worldPos = {chunkWorldX, chunkWorldY};
+            
+            IntCoord coord = {chunkX, chunkY};
+            ChunkRenderData* chunk = direct ? NULL : (ChunkRenderData*)Table_get(system->chunks, &coord);
+            if (direct || (fillGaps && (!chunk || !chunk->isLoaded))) {
+                RenderVector2 screenPos = system->backend->world_to_screen(system->backendContext, camera, aspectFit, worldPos);
+                chunk_direct_queue(system, chunkX, chunkY, &region, screenPos, zoom * scale);
+                continue;
+            }
+            if (!chunk) continue;
+            
+            if (chunk->isLoaded) {
+                RenderVector2 screenPos = system->backend->world_to_screen(system->backendContext, camera, aspectFit, worldPos);
+                RenderRect dstRect = {
+                    screenPos.x,
+                    screenPos.y,
+                    chunkPixelSize * zoom * scale,
+                    chunkPixelSize * zoom * scale
+                };
+                if (paged && chunk_page_queue(system, (ChunkSlot*)chunk, dstRect)) continue;
+                
+                float texturePixelSize;
+                void* textureHandle = chunk_lod_texture(system, (ChunkSlot*)chunk, lodLevel, &texturePixelSize);
+                RenderRect srcRect = {0, 0, texturePixelSize, -texturePixelSize};
+                
+                if (textureHandle) {
+                    RenderCommand texProCmd = {
+                        .type = RENDER_COMMAND_TYPE_TEXTURE_PRO,
+                        .bounds = dstRect,
+                        .color = color_white(),
+                        .data.texture = {
+                            .textureHandle = textureHandle,
+                            .srcRect = srcRect,
+                            .rotation = 0.0f,
+                            .origin = {0, 0}
                         }
-                    }
-                    
-                    if (needsRender) {
-                        render_chunk_tiles(system, chunk);
-                        chunk->isDirty = false;
-                    }
+                    };
+                    system->backend->execute_command(system->backendContext, &texProCmd);
+                    CHUNK_STAT_ADD(system, drawCommands, 1);
                 }
             }
         }
     }
     
-#ifdef HAS_CHUNK_MANAGER
-    if (chunkManager) {
-        ChunkManagerSystem_clear_dirty(chunkManager);
+    if (direct || fillGaps) {
+        chunk_direct_flush(system);
     }
-#endif
+    if (paged) {
+        chunk_page_flush(system);
+    }
+    
+    // The render mode is picked by the next update, once every view of the
+    // frame has been counted
+    system->frameVisibleTiles += visibleTiles;
+    system->frameRendered = true;
 }
 
 void ChunkRenderSystem_render(ChunkRenderSystem* system,
@@ -320,75 +477,73 @@ void ChunkRenderSystem_render(ChunkRenderSystem* system,
                               ComponentTypeId positionTypeId,
                               CameraHandle camera, 
                               AspectFitHandle aspectFit) {
-    if (!system || !system->renderer || !camera || !aspectFit) return;
+    if (!system || !system->backendContext || !camera || !aspectFit) return;
     
-    Table_T renderedChunks = Table_new(128, IntCoord_cmp, IntCoord_hash);
+    uint64_t startMicros = CHUNK_STAT_NOW();
+    CHUNK_TRACE_BEGIN(system, "ChunkRenderSystem_render");
+    render_view(system, ecs, positionTypeId, camera, aspectFit,
+                system->viewportWidth, system->viewportHeight, &system->lodLevel, NULL);
+    CHUNK_TRACE_END(system, "ChunkRenderSystem_render");
+    CHUNK_STAT_ADD(system, renderMicros, CHUNK_STAT_NOW() - startMicros);
+}
+
+static ChunkRenderViewport* get_viewport(ChunkRenderSystem* system, int viewport) {
+    if (!system || viewport < 0 || viewport >= CHUNK_RENDER_MAX_VIEWPORTS) return NULL;
+    ChunkRenderViewport* view = &system->viewports[viewport];
+    return view->active ? view : NULL;
+}
+
+int ChunkRenderSystem_add_viewport(ChunkRenderSystem* system, float width, float height) {
+    if (!system) return -1;
     
-    for (size_t i = 0; i < system->observerCount; i++) {
-        int observerTileX, observerTileY;
-        get_observer_tile_pos(system, &system->observers[i], ecs, positionTypeId, &observerTileX, &observerTileY);
-        
-        int observerChunkX, observerChunkY;
-        get_chunk_coord(system, observerTileX, observerTileY, &observerChunkX, &observerChunkY);
+    for (int i = 0; i < CHUNK_RENDER_MAX_VIEWPORTS; i++) {
+        ChunkRenderViewport* view = &system->viewports[i];
+        if (view->active) continue;
         
-        for (int dy = -system->renderRadius; dy <= system->renderRadius; dy++) {
-            for (int dx = -system->renderRadius; dx <= system->renderRadius; dx++) {
-                int chunkX = observerChunkX + dx;
-                int chunkY = observerChunkY + dy;
-                
-                float dist = sqrtf((float)(dx * dx + dy * dy));
-                if (dist <= (float)system->renderRadius) {
-                    IntCoord coord = {chunkX, chunkY};
-                    
-                    if (Table_get(renderedChunks, &coord)) {
-                        continue;
-                    }
-                    
-                    IntCoord* key = (IntCoord*)Arena_alloc(system->arena, sizeof(IntCoord), __FILE__, __LINE__);
-                    key->x = chunkX;
-                    key->y = chunkY;
-                    Table_put(renderedChunks, key, (void*)1);
-                    
-                    ChunkRenderData* chunk = (ChunkRenderData*)Table_get(system->chunks, &coord);
-                    if (chunk && chunk->isLoaded) {
-                        float chunkWorldX = (float)(chunkX * system->chunkSize * system->tileSize);
-                        float chunkWorldY = (float)(chunkY * system->chunkSize * system->tileSize);
-                        
-                        RenderVector2 worldPos = {chunkWorldX, chunkWorldY};
-                        RenderVector2 screenPos = Renderer_world_to_screen(system->renderer, camera, aspectFit, worldPos);
-                        
-                        float zoom = Renderer_get_camera_zoom(system->renderer, camera);
-                        float scale = Renderer_get_aspect_fit_scale(system->renderer, aspectFit);
-                        
-                        float chunkPixelSize = (float)(system->chunkSize * system->tileSize);
-                        RenderRect srcRect = {0, 0, chunkPixelSize, -chunkPixelSize};
-                        RenderRect dstRect = {
-                            screenPos.x,
-                            screenPos.y,
-                            chunkPixelSize * zoom * scale,
-                            chunkPixelSize * zoom * scale
-                        };
-                        
-                        void* textureHandle = Renderer_get_render_texture_texture(system->renderer, chunk->renderTexture);
-                        if (textureHandle) {
-                            RenderCommand texProCmd = {
-                                .type = RENDER_COMMAND_TYPE_TEXTURE_PRO,
-                                .bounds = dstRect,
-                                .color = color_white(),
-                                .data.texture = {
-                                    .textureHandle = textureHandle,
-                                    .srcRect = srcRect,
-                                    .rotation = 0.0f,
-                                    .origin = {0, 0}
-                                }
-                            };
-                            Renderer_execute_command(system->renderer, &texProCmd);
-                        }
-                    }
-                }
-            }
-        }
+        view->width = width;
+        view->height = height;
+        view->lodLevel = 0;
+        view->active = true;
+        return i;
+    }
+    return -1;
+}
+
+void ChunkRenderSystem_resize_viewport(ChunkRenderSystem* system, int viewport, float width, float height) {
+    ChunkRenderViewport* view = get_viewport(system, viewport);
+    if (!view) return;
+    view->width = width;
+    view->height = height;
+}
+
+void ChunkRenderSystem_remove_viewport(ChunkRenderSystem* system, int viewport) {
+    ChunkRenderViewport* view = get_viewport(system, viewport);
+    if (!view) return;
+    if (view->hasChunkRect) {
+        chunk_coverage_invalidate(system);
     }
+    memset(view, 0, sizeof(*view));
+}
+
+void ChunkRenderSystem_render_viewport(ChunkRenderSystem* system,
+                                       int viewport,
+                                       ECS* ecs,
+                                       ComponentTypeId positionTypeId,
+                                       CameraHandle camera,
+                                       AspectFitHandle aspectFit) {
+    ChunkRenderViewport* view = get_viewport(system, viewport);
+    if (!view || !system->backendContext || !camera || !aspectFit) return;
+    
+    uint64_t startMicros = CHUNK_STAT_NOW();
+    CHUNK_TRACE_BEGIN(system, "ChunkRenderSystem_render_viewport");
+    render_view(system, ecs, positionTypeId, camera, aspectFit, view->width, view->height, &view->lodLevel, view);
+    CHUNK_TRACE_END(system, "ChunkRenderSystem_render_viewport");
+    CHUNK_STAT_ADD(system, renderMicros, CHUNK_STAT_NOW() - startMicros);
+}
+
+int ChunkRenderSystem_get_viewport_lod_level(ChunkRenderSystem* system, int viewport) {
+    ChunkRenderViewport* view = get_viewport(system, viewport);
+    return view ? view->lodLevel : 0;
 }
 
 void ChunkRenderSystem_get_chunk_coord(ChunkRenderSystem* system,
@@ -411,9 +566,9 @@ bool ChunkRenderSystem_handle_click(ChunkRenderSystem* system,
                                     AspectFitHandle aspectFit,
                                     int* outTileX,
                                     int* outTileY) {
-    if (!system || !system->renderer || !camera || !aspectFit) return false;
+    if (!system || !system->backendContext || !camera || !aspectFit) return false;
     
-    RenderVector2 world = Renderer_screen_to_world(system->renderer, camera, aspectFit, mousePos);
+    RenderVector2 world = system->backend->screen_to_world(system->backendContext, camera, aspectFit, mousePos);
     
     int tileX = (int)floorf(world.x / (float)system->tileSize);
     int tileY = (int)floorf(world.y / (float)system->tileSize);
@@ -430,15 +585,119 @@ void ChunkRenderSystem_mark_chunk_dirty(ChunkRenderSystem* system, int tileX, in
     int chunkX, chunkY;
     get_chunk_coord(system, tileX, tileY, &chunkX, &chunkY);
     
+    chunk_prefetch_invalidate(system, chunkX, chunkY);
+    chunk_direct_note_dirty(system, (size_t)system->chunkSize * (size_t)system->chunkSize);
+    
     IntCoord coord = {chunkX, chunkY};
     ChunkRenderData* chunk = (ChunkRenderData*)Table_get(system->chunks, &coord);
     if (chunk) {
-        chunk->isDirty = true;
+        chunk_mark_slot_dirty(system, (ChunkSlot*)chunk);
+    }
+}
+
+void ChunkRenderSystem_set_residency_budget(ChunkRenderSystem* system,
+                                            size_t maxChunks,
+                                            size_t maxBytes) {
+    if (!system) return;
+    system->maxResidentChunks = maxChunks;
+    system->maxResidentBytes = maxBytes;
+    // Viewport windows are clamped to the chunk budget
+    chunk_coverage_invalidate(system);
+}
+
+void ChunkRenderSystem_set_viewport_size(ChunkRenderSystem* system, float width, float height) {
+    if (!system) return;
+    system->viewportWidth = width;
+    system->viewportHeight = height;
+}
+
+void ChunkRenderSystem_set_backend(ChunkRenderSystem* system,
+                                   const ChunkRenderBackend* backend,
+                                   void* context) {
+    if (!system) return;
+    system->backend = backend ? backend : ChunkRenderBackend_renderer();
+    system->backendContext = backend ? context : system->renderer;
+}
+
+void ChunkRenderSystem_set_tile_row_fetch(ChunkRenderSystem* system,
+                                          ChunkRenderTileRowFn fetch,
+                                          void* userData) {
+    if (!system) return;
+    system->tileRowFetch = fetch;
+    system->tileRowFetchUserData = userData;
+}
+
+void ChunkRenderSystem_set_batch_submit(ChunkRenderSystem* system,
+                                        ChunkRenderBatchSubmitFn submit,
+                                        void* userData) {
+    if (!system) return;
+    system->batchSubmit = submit;
+    system->batchSubmitUserData = userData;
+}
+
+void ChunkRenderSystem_set_rebuild_budget(ChunkRenderSystem* system,
+                                          int maxChunksPerFrame,
+                                          uint32_t maxMicrosPerFrame) {
+    if (!system) return;
+    system->maxRebuildsPerFrame = maxChunksPerFrame;
+    system->maxRebuildMicros = maxMicrosPerFrame;
+}
+
+size_t ChunkRenderSystem_get_rebuild_queue_depth(ChunkRenderSystem* system) {
+    if (!system) return 0;
+    return system->rebuildQueueDepth;
+}
+
+size_t ChunkRenderSystem_get_resident_count(ChunkRenderSystem* system) {
+    if (!system) return 0;
+    return system->residentCount;
+}
+
+size_t ChunkRenderSystem_get_resident_bytes(ChunkRenderSystem* system) {
+    if (!system) return 0;
+    return chunk_resident_texture_bytes(system) + chunk_disk_cache_pending_bytes(system);
+}
+
+void ChunkRenderSystem_mark_tile_dirty(ChunkRenderSystem* system, int tileX, int tileY) {
+    if (!system) return;
+    
+    int chunkX, chunkY;
+    get_chunk_coord(system, tileX, tileY, &chunkX, &chunkY);
+    
+    chunk_prefetch_invalidate(system, chunkX, chunkY);
+    chunk_direct_note_dirty(system, 1);
+    
+    IntCoord coord = {chunkX, chunkY};
+    ChunkRenderData* chunk = (ChunkRenderData*)Table_get(system->chunks, &coord);
+    if (chunk) {
+        ChunkTileRegion region = {0, 0, 1, 1};
+        get_local_coord(system, tileX, tileY, &region.localX, &region.localY);
+        chunk_mark_slot_region_dirty(system, (ChunkSlot*)chunk, &region);
     }
 }
 
 void ChunkRenderSystem_cleanup(ChunkRenderSystem* system) {
     if (!system) return;
+    
+    ChunkRenderSystem_disable_prefetch(system);
+    chunk_rebuild_jobs_release(system);
+    ChunkRenderSystem_disable_disk_cache(system);
+    chunk_residency_release_all(system);
+    chunk_dedup_release_all(system);
+    chunk_page_release_all(system);
+    chunk_render_target_pool_release_all(system);
+    chunk_observers_release(system);
+    chunk_dirty_batch_release(system);
+    if (system->chunks) {
+        Table_free(&system->chunks);
+    }
+    
+    // Slots and the pool array live in the caller's arena
+    system->freeSlots = NULL;
+    system->renderTargetPool = NULL;
+    system->renderTargetPoolCapacity = 0;
+    system->rebuildBatch = NULL;
+    system->rebuildBatchCapacity = 0;
 }
 
 
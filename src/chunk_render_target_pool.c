@@ -0,0 +1,80 @@
+#include "chunk_render_internal.h"
+#include <string.h>
+
+void* chunk_render_target_acquire(ChunkRenderSystem* system) {
+    if (!system->backendContext) return NULL;
+    
+    if (system->renderTargetPoolCount > 0) {
+        system->renderTargetPoolHits++;
+        return system->renderTargetPool[--system->renderTargetPoolCount];
+    }
+    
+    system->renderTargetPoolMisses++;
+    int chunkPixelSize = system->chunkSize * system->tileSize;
+    return system->backend->create_render_texture(system->backendContext, chunkPixelSize, chunkPixelSize);
+}
+
+void chunk_render_target_release(ChunkRenderSystem* system, void* renderTexture) {
+    if (!renderTexture || !system->backendContext) return;
+    if (chunk_disk_cache_adopt(system, renderTexture)) return;
+    
+    if (system->renderTargetPoolCount < system->renderTargetPoolCapacity) {
+        system->renderTargetPool[system->renderTargetPoolCount++] = renderTexture;
+    } else {
+        system->backend->destroy_render_texture(system->backendContext, renderTexture);
+    }
+}
+
+void chunk_render_target_pool_release_all(ChunkRenderSystem* system) {
+    while (system->renderTargetPoolCount > 0) {
+        void* renderTexture = system->renderTargetPool[--system->renderTargetPoolCount];
+        if (system->backendContext) {
+            system->backend->destroy_render_texture(system->backendContext, renderTexture);
+        }
+    }
+}
+
+void ChunkRenderSystem_configure_render_target_pool(ChunkRenderSystem* system,
+                                                    size_t capacity,
+                                                    size_t prewarmCount) {
+    if (!system) return;
+    
+    // Shrinking destroys targets that no longer fit
+    while (system->renderTargetPoolCount > capacity) {
+        void* renderTexture = system->renderTargetPool[--system->renderTargetPoolCount];
+        if (system->backendContext) {
+            system->backend->destroy_render_texture(system->backendContext, renderTexture);
+        }
+    }
+    
+    if (capacity > system->renderTargetPoolCapacity) {
+        void** newPool = (void**)chunk_arena_alloc(system, sizeof(void*) * capacity, __FILE__, __LINE__);
+        if (system->renderTargetPoolCount > 0) {
+            memcpy(newPool, system->renderTargetPool, sizeof(void*) * system->renderTargetPoolCount);
+        }
+        system->renderTargetPool = newPool;
+    }
+    system->renderTargetPoolCapacity = capacity;
+    
+    if (prewarmCount > capacity) {
+        prewarmCount = capacity;
+    }
+    if (!system->backendContext) return;
+    
+    int chunkPixelSize = system->chunkSize * system->tileSize;
+    while (system->renderTargetPoolCount < prewarmCount) {
+        void* renderTexture = system->backend->create_render_texture(system->backendContext, chunkPixelSize, chunkPixelSize);
+        if (!renderTexture) break;
+        system->renderTargetPool[system->renderTargetPoolCount++] = renderTexture;
+    }
+}
+
+ChunkRenderTargetPoolStats ChunkRenderSystem_get_render_target_pool_stats(ChunkRenderSystem* system) {
+    ChunkRenderTargetPoolStats stats = {0};
+    if (!system) return stats;
+    stats.hits = system->renderTargetPoolHits;
+    stats.misses = system->renderTargetPoolMisses;
+    stats.available = system->renderTargetPoolCount;
+    stats.capacity = system->renderTargetPoolCapacity;
+    return stats;
+}
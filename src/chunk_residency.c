@@ -0,0 +1,115 @@
+#include "chunk_render_internal.h"
+#include <string.h>
+
+size_t chunk_texture_bytes(ChunkRenderSystem* system) {
+    size_t chunkPixelSize = (size_t)system->chunkSize * (size_t)system->tileSize;
+    return chunkPixelSize * chunkPixelSize * 4;
+}
+
+size_t chunk_resident_texture_bytes(ChunkRenderSystem* system) {
+    size_t withoutTarget = system->lodOnlyChunks + system->pageOnlyChunks;
+    return (system->residentCount - system->sharedTextureRefs - withoutTarget) * chunk_texture_bytes(system) +
+           system->lodTextureBytes + chunk_page_bytes(system);
+}
+
+ChunkSlot* chunk_slot_acquire(ChunkRenderSystem* system) {
+    ChunkSlot* slot = system->freeSlots;
+    if (slot) {
+        system->freeSlots = slot->next;
+    } else {
+        slot = (ChunkSlot*)chunk_arena_alloc(system, sizeof(ChunkSlot), __FILE__, __LINE__);
+    }
+    memset(slot, 0, sizeof(ChunkSlot));
+    return slot;
+}
+
+static void residency_unlink(ChunkRenderSystem* system, ChunkSlot* slot) {
+    if (slot->prev) {
+        slot->prev->next = slot->next;
+    } else {
+        system->residentHead = slot->next;
+    }
+    if (slot->next) {
+        slot->next->prev = slot->prev;
+    } else {
+        system->residentTail = slot->prev;
+    }
+    slot->prev = NULL;
+    slot->next = NULL;
+}
+
+static void residency_append(ChunkRenderSystem* system, ChunkSlot* slot) {
+    slot->prev = system->residentTail;
+    slot->next = NULL;
+    if (system->residentTail) {
+        system->residentTail->next = slot;
+    } else {
+        system->residentHead = slot;
+    }
+    system->residentTail = slot;
+}
+
+void chunk_residency_insert(ChunkRenderSystem* system, ChunkSlot* slot) {
+    residency_append(system, slot);
+    system->residentCount++;
+}
+
+void chunk_residency_touch(ChunkRenderSystem* system, ChunkSlot* slot) {
+    slot->data.lastUpdateFrame = system->currentFrame;
+    if (system->residentTail != slot) {
+        residency_unlink(system, slot);
+        residency_append(system, slot);
+    }
+}
+
+static void release_slot(ChunkRenderSystem* system, ChunkSlot* slot) {
+    chunk_disk_cache_queue(system, slot);
+    Table_remove(system->chunks, &slot->key);
+    if (!chunk_dedup_release(system, slot)) {
+        chunk_render_target_release(system, slot->data.renderTexture);
+    }
+    slot->data.renderTexture = NULL;
+    if (slot->lodOnly) {
+        system->lodOnlyChunks--;
+    }
+    if (slot->pageOnly) {
+        slot->pageOnly = false;
+        system->pageOnlyChunks--;
+    }
+    chunk_lod_release(system, slot);
+    chunk_page_release(system, slot);
+    residency_unlink(system, slot);
+    system->residentCount--;
+    
+    slot->next = system->freeSlots;
+    system->freeSlots = slot;
+}
+
+static bool over_budget(ChunkRenderSystem* system) {
+    if (system->maxResidentChunks > 0 && system->residentCount > system->maxResidentChunks) {
+        return true;
+    }
+    if (system->maxResidentBytes > 0 &&
+        chunk_resident_texture_bytes(system) > system->maxResidentBytes) {
+        return true;
+    }
+    return false;
+}
+
+void chunk_residency_enforce_budget(ChunkRenderSystem* system) {
+    // The list is ordered by last visible frame, so the head is always the
+    // best eviction candidate; stop at the first chunk seen this frame
+    while (over_budget(system)) {
+        ChunkSlot* victim = system->residentHead;
+        if (!victim || victim->data.lastUpdateFrame >= system->currentFrame) {
+            break;
+        }
+        release_slot(system, victim);
+    }
+}
+
+void chunk_residency_release_all(ChunkRenderSystem* system) {
+    while (system->residentHead) {
+        release_slot(system, system->residentHead);
+    }
+}
@@ -0,0 +1,88 @@
+#include "chunk_thread.h"
+
+#if CHUNK_RENDER_HAS_THREADS
+#include <stdlib.h>
+
+typedef struct ChunkThreadStart {
+    ChunkThreadFn fn;
+    void* arg;
+} ChunkThreadStart;
+
+#if defined(_WIN32)
+
+void ChunkMutex_init(ChunkMutex* mutex) { InitializeCriticalSection(mutex); }
+void ChunkMutex_destroy(ChunkMutex* mutex) { DeleteCriticalSection(mutex); }
+void ChunkMutex_lock(ChunkMutex* mutex) { EnterCriticalSection(mutex); }
+void ChunkMutex_unlock(ChunkMutex* mutex) { LeaveCriticalSection(mutex); }
+
+void ChunkCond_init(ChunkCond* cond) { InitializeConditionVariable(cond); }
+void ChunkCond_destroy(ChunkCond* cond) { (void)cond; }
+void ChunkCond_wait(ChunkCond* cond, ChunkMutex* mutex) { SleepConditionVariableCS(cond, mutex, INFINITE); }
+void ChunkCond_signal(ChunkCond* cond) { WakeConditionVariable(cond); }
+void ChunkCond_broadcast(ChunkCond* cond) { WakeAllConditionVariable(cond); }
+
+static DWORD WINAPI thread_entry(LPVOID param) {
+    ChunkThreadStart start = *(ChunkThreadStart*)param;
+    free(param);
+    start.fn(start.arg);
+    return 0;
+}
+
+bool ChunkThread_start(ChunkThread* thread, ChunkThreadFn fn, void* arg) {
+    ChunkThreadStart* start = (ChunkThreadStart*)malloc(sizeof(ChunkThreadStart));
+    if (!start) return false;
+    start->fn = fn;
+    start->arg = arg;
+    
+    *thread = CreateThread(NULL, 0, thread_entry, start, 0, NULL);
+    if (!*thread) {
+        free(start);
+        return false;
+    }
+    return true;
+}
+
+void ChunkThread_join(ChunkThread thread) {
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+
+#else
+
+void ChunkMutex_init(ChunkMutex* mutex) { pthread_mutex_init(mutex, NULL); }
+void ChunkMutex_destroy(ChunkMutex* mutex) { pthread_mutex_destroy(mutex); }
+void ChunkMutex_lock(ChunkMutex* mutex) { pthread_mutex_lock(mutex); }
+void ChunkMutex_unlock(ChunkMutex* mutex) { pthread_mutex_unlock(mutex); }
+
+void ChunkCond_init(ChunkCond* cond) { pthread_cond_init(cond, NULL); }
+void ChunkCond_destroy(ChunkCond* cond) { pthread_cond_destroy(cond); }
+void ChunkCond_wait(ChunkCond* cond, ChunkMutex* mutex) { pthread_cond_wait(cond, mutex); }
+void ChunkCond_signal(ChunkCond* cond) { pthread_cond_signal(cond); }
+void ChunkCond_broadcast(ChunkCond* cond) { pthread_cond_broadcast(cond); }
+
+static void* thread_entry(void* param) {
+    ChunkThreadStart start = *(ChunkThreadStart*)param;
+    free(param);
+    start.fn(start.arg);
+    return NULL;
+}
+
+bool ChunkThread_start(ChunkThread* thread, ChunkThreadFn fn, void* arg) {
+    ChunkThreadStart* start = (ChunkThreadStart*)malloc(sizeof(ChunkThreadStart));
+    if (!start) return false;
+    start->fn = fn;
+    start->arg = arg;
+    
+    if (pthread_create(thread, NULL, thread_entry, start) != 0) {
+        free(start);
+        return false;
+    }
+    return true;
+}
+
+void ChunkThread_join(ChunkThread thread) {
+    pthread_join(thread, NULL);
+}
+
+#endif
+#endif
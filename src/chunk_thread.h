@@ -0,0 +1,52 @@
+#ifndef CHUNK_THREAD_H
+#define CHUNK_THREAD_H
+
+// Minimal threading shim for the chunk renderer's worker threads
+// CHUNK_RENDER_HAS_THREADS is 0 when threads are disabled in CMake or the
+// platform has none (Emscripten without pthreads); callers then fall back
+// to doing the work on the calling thread
+
+#include <stdbool.h>
+
+#ifndef GRAMARYE_CHUNK_RENDERER_THREADS
+#define GRAMARYE_CHUNK_RENDERER_THREADS 1
+#endif
+
+#if GRAMARYE_CHUNK_RENDERER_THREADS && (!defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__))
+#define CHUNK_RENDER_HAS_THREADS 1
+#else
+#define CHUNK_RENDER_HAS_THREADS 0
+#endif
+
+#if CHUNK_RENDER_HAS_THREADS
+#if defined(_WIN32)
+#include <windows.h>
+typedef CRITICAL_SECTION ChunkMutex;
+typedef CONDITION_VARIABLE ChunkCond;
+typedef HANDLE ChunkThread;
+#else
+#include <pthread.h>
+typedef pthread_mutex_t ChunkMutex;
+typedef pthread_cond_t ChunkCond;
+typedef pthread_t ChunkThread;
+#endif
+
+typedef void (*ChunkThreadFn)(void* arg);
+
+void ChunkMutex_init(ChunkMutex* mutex);
+void ChunkMutex_destroy(ChunkMutex* mutex);
+void ChunkMutex_lock(ChunkMutex* mutex);
+void ChunkMutex_unlock(ChunkMutex* mutex);
+
+void ChunkCond_init(ChunkCond* cond);
+void ChunkCond_destroy(ChunkCond* cond);
+void ChunkCond_wait(ChunkCond* cond, ChunkMutex* mutex);
+void ChunkCond_signal(ChunkCond* cond);
+void ChunkCond_broadcast(ChunkCond* cond);
+
+// Start a thread running fn(arg); returns false on failure
+bool ChunkThread_start(ChunkThread* thread, ChunkThreadFn fn, void* arg);
+void ChunkThread_join(ChunkThread thread);
+#endif
+
+#endif // CHUNK_THREAD_H
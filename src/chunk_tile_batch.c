@@ -0,0 +1,240 @@
+#include "chunk_render_internal.h"
+#include "textures/atlas.h"
+#include "tilemap/tilemap.h"
+
+static RenderColor color_white(void) {
+    RenderColor c = {255, 255, 255, 255};
+    return c;
+}
+
+static RenderColor color_black(void) {
+    RenderColor c = {0, 0, 0, 255};
+    return c;
+}
+
+void chunk_gather_tile_ids(ChunkRenderSystem* system,
+                           int chunkX, int chunkY,
+                           const ChunkTileRegion* region,
+                           int* outTileIds) {
+    int startTileX = chunkX * system->chunkSize + region->localX;
+    int startTileY = chunkY * system->chunkSize + region->localY;
+    
+    for (int row = 0; row < region->height; row++) {
+        int* ids = outTileIds + (size_t)row * (size_t)region->width;
+        int tileY = startTileY + row;
+        
+        if (system->tileRowFetch &&
+            system->tileRowFetch(system->tilemap, startTileX, tileY, region->width, ids, system->tileRowFetchUserData)) {
+            continue;
+        }
+        
+        for (int col = 0; col < region->width; col++) {
+            Tile* tile = system->tilemap ? Tilemap_get_tile(system->tilemap, startTileX + col, tileY) : NULL;
+            ids[col] = tile ? (int)tile->tile_id : CHUNK_RENDER_EMPTY_TILE;
+        }
+    }
+}
+
+size_t chunk_build_tile_quads(ChunkRenderSystem* system,
+                              const int* tileIds,
+                              const ChunkTileRegion* region,
+                              ChunkTileQuad* outQuads,
+                              bool sharedAtlas) {
+    float tileSize = (float)system->tileSize;
+    size_t count = 0;
+    
+    for (int row = 0; row < region->height; row++) {
+        const int* ids = tileIds + (size_t)row * (size_t)region->width;
+        float dstY = (float)(region->localY + row) * tileSize;
+        
+        for (int col = 0; col < region->width; col++) {
+            int tileId = ids[col];
+            if (tileId == CHUNK_RENDER_EMPTY_TILE) continue;
+            
+            ChunkTileQuad* quad = &outQuads[count++];
+            quad->srcRect = sharedAtlas ? chunk_atlas_rect_shared(system, tileId) : chunk_atlas_rect(system, tileId);
+            quad->dstRect.x = (float)(region->localX + col) * tileSize;
+            quad->dstRect.y = dstY;
+            quad->dstRect.width = tileSize;
+            quad->dstRect.height = tileSize;
+        }
+    }
+    
+    return count;
+}
+
+void chunk_submit_tile_quads(ChunkRenderSystem* system, const ChunkTileQuad* quads, size_t count) {
+    void* atlasTexture = &system->atlas->texture;
+    CHUNK_STAT_ADD(system, tilesEmitted, count);
+    
+    if (system->batchSubmit &&
+        system->batchSubmit(system->renderer, atlasTexture, quads, count, system->batchSubmitUserData)) {
+        CHUNK_STAT_ADD(system, drawCommands, 1);
+        return;
+    }
+    
+    // Backend has no batch support: one texture command per tile
+    RenderCommand texCmd = {
+        .type = RENDER_COMMAND_TYPE_TEXTURE,
+        .color = color_white(),
+        .data.texture = {
+            .textureHandle = atlasTexture,
+            .rotation = 0.0f,
+            .origin = {0, 0}
+        }
+    };
+    for (size_t i = 0; i < count; i++) {
+        texCmd.bounds = quads[i].dstRect;
+        texCmd.data.texture.srcRect = quads[i].srcRect;
+        system->backend->execute_command(system->backendContext, &texCmd);
+    }
+    CHUNK_STAT_ADD(system, drawCommands, count);
+}
+
+static void upload_region(ChunkRenderSystem* system, ChunkRenderData* chunk, const ChunkTileRegion* region,
+                          const ChunkTileQuad* quads, size_t count) {
+    system->backend->begin_render_texture(system->backendContext, chunk->renderTexture);
+    
+    // Only the redrawn region is cleared; the rest of the texture is kept
+    float tileSize = (float)system->tileSize;
+    RenderCommand clearCmd = {
+        .type = RENDER_COMMAND_TYPE_RECTANGLE,
+        .bounds = {
+            (float)region->localX * tileSize,
+            (float)region->localY * tileSize,
+            (float)region->width * tileSize,
+            (float)region->height * tileSize
+        },
+        .color = color_black()
+    };
+    system->backend->execute_command(system->backendContext, &clearCmd);
+    CHUNK_STAT_ADD(system, drawCommands, 1);
+    
+    chunk_submit_tile_quads(system, quads, count);
+    
+    system->backend->end_render_texture(system->backendContext);
+}
+
+void chunk_upload_tile_quads(ChunkRenderSystem* system, ChunkRenderData* chunk, const ChunkTileQuad* quads, size_t count) {
+    ChunkTileRegion region = {0, 0, system->chunkSize, system->chunkSize};
+    upload_region(system, chunk, &region, quads, count);
+}
+
+bool chunk_rebuild_region(ChunkRenderSystem* system, ChunkRenderData* chunk, ChunkTileRegion* outRegion) {
+    if (!chunk || (!system->tilemap && !system->tileRowFetch) || !system->atlas || !system->backendContext) return false;
+    
+    // Split a shared texture off before drawing into it; a fresh copy is blank
+    ChunkSlot* slot = (ChunkSlot*)chunk;
+    if (chunk_dedup_detach(system, slot)) {
+        chunk->isDirty = true;
+    }
+    // An LOD-only chunk takes a target again and is redrawn in full
+    if (slot->lodOnly) {
+        chunk->renderTexture = chunk_render_target_acquire(system);
+        if (!chunk->renderTexture) return false;
+        slot->lodOnly = false;
+        system->lodOnlyChunks--;
+        chunk->isDirty = true;
+    }
+    // So does a chunk held only by its page cell; the cell is recopied after
+    if (slot->pageOnly) {
+        chunk->renderTexture = chunk_render_target_acquire(system);
+        if (!chunk->renderTexture) return false;
+        slot->pageOnly = false;
+        system->pageOnlyChunks--;
+        chunk->isDirty = true;
+    }
+    if (!chunk->renderTexture) return false;
+    
+    ChunkTileRegion region = {0, 0, system->chunkSize, system->chunkSize};
+    
+    // A loaded chunk with only tile-level changes is patched in place
+    if (chunk->isLoaded && !chunk->isDirty && slot->hasDirtyRegion) {
+        region = slot->dirtyRegion;
+    }
+    *outRegion = region;
+    return true;
+}
+
+uint64_t chunk_tile_hash(const int* tileIds, size_t count) {
+    // FNV-1a over whole tile ids
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < count; i++) {
+        hash ^= (uint32_t)tileIds[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static void mark_rebuilt(ChunkRenderSystem* system, ChunkRenderData* chunk) {
+    CHUNK_STAT_ADD(system, chunksRebuilt, 1);
+    ((ChunkSlot*)chunk)->hasDirtyRegion = false;
+    ((ChunkSlot*)chunk)->lodValid = 0;
+    ((ChunkSlot*)chunk)->fullResFrame = system->currentFrame;
+    ((ChunkSlot*)chunk)->pageValid = false;
+    chunk->isDirty = false;
+    chunk->isLoaded = true;
+}
+
+bool chunk_rebuild_from_prefetch(ChunkRenderSystem* system, ChunkRenderData* chunk, const ChunkTileRegion* region) {
+    // Full rebuilds take the prefetched quads when the worker already built them
+    if (region->width != system->chunkSize || region->height != system->chunkSize ||
+        !chunk_prefetch_upload(system, chunk)) {
+        return false;
+    }
+    CHUNK_STAT_ADD(system, prefetchUploads, 1);
+    mark_rebuilt(system, chunk);
+    ((ChunkSlot*)chunk)->hasContentHash = false;
+    return true;
+}
+
+bool chunk_rebuild_hashes(ChunkRenderSystem* system, const ChunkTileRegion* region) {
+    return (system->dedupEnabled || system->diskCache) &&
+           region->width == system->chunkSize && region->height == system->chunkSize;
+}
+
+bool chunk_rebuild_from_cache(ChunkRenderSystem* system, ChunkRenderData* chunk, const ChunkTileRegion* region,
+                              const int* tileIds) {
+    ChunkSlot* slot = (ChunkSlot*)chunk;
+    slot->hasContentHash = false;
+    if (!chunk_rebuild_hashes(system, region)) return false;
+    
+    // Kept on the slot for registering and storing this chunk later
+    slot->contentHash = chunk_tile_hash(tileIds, (size_t)region->width * (size_t)region->height);
+    slot->hasContentHash = true;
+    if (chunk_dedup_share(system, slot, tileIds)) {
+        mark_rebuilt(system, chunk);
+        return true;
+    }
+    if (!chunk_disk_cache_load(system, chunk, slot->contentHash)) return false;
+    
+    CHUNK_STAT_ADD(system, diskCacheLoads, 1);
+    mark_rebuilt(system, chunk);
+    chunk_dedup_register(system, slot, tileIds);
+    return true;
+}
+
+size_t chunk_prepare_tiles(ChunkRenderSystem* system, ChunkRenderData* chunk, const ChunkTileRegion* region,
+                           int* tileIds, ChunkTileQuad* quads, bool sharedAtlas) {
+    chunk_gather_tile_ids(system, chunk->chunkX, chunk->chunkY, region, tileIds);
+    return chunk_build_tile_quads(system, tileIds, region, quads, sharedAtlas);
+}
+
+void chunk_finish_tiles(ChunkRenderSystem* system, ChunkRenderData* chunk, const ChunkTileRegion* region,
+                        const int* tileIds, const ChunkTileQuad* quads, size_t count) {
+    upload_region(system, chunk, region, quads, count);
+    mark_rebuilt(system, chunk);
+    chunk_dedup_register(system, (ChunkSlot*)chunk, tileIds);
+}
+
+void chunk_render_tiles(ChunkRenderSystem* system, ChunkRenderData* chunk) {
+    ChunkTileRegion region;
+    if (!chunk_rebuild_region(system, chunk, &region)) return;
+    if (chunk_rebuild_from_prefetch(system, chunk, &region)) return;
+    
+    chunk_gather_tile_ids(system, chunk->chunkX, chunk->chunkY, &region, system->tileIds);
+    if (chunk_rebuild_from_cache(system, chunk, &region, system->tileIds)) return;
+    
+    size_t count = chunk_build_tile_quads(system, system->tileIds, &region, system->tileQuads, false);
+    chunk_finish_tiles(system, chunk, &region, system->tileIds, system->tileQuads, count);
+}
@@ -0,0 +1,173 @@
+#include "gramarye_chunk_renderer/recording_renderer.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Render textures are plain size records; nothing is drawn
+typedef struct RecordingTexture {
+    int width;
+    int height;
+} RecordingTexture;
+
+static size_t texture_bytes(const RecordingTexture* texture) {
+    return (size_t)texture->width * (size_t)texture->height * 4;
+}
+
+static void* recording_create_render_texture(void* context, int width, int height) {
+    RecordingRenderer* recorder = (RecordingRenderer*)context;
+    RecordingTexture* texture = (RecordingTexture*)malloc(sizeof(RecordingTexture));
+    if (!texture) return NULL;
+    
+    texture->width = width;
+    texture->height = height;
+    
+    recorder->textureCreations++;
+    recorder->liveTextures++;
+    recorder->liveTextureBytes += texture_bytes(texture);
+    if (recorder->liveTextureBytes > recorder->peakTextureBytes) {
+        recorder->peakTextureBytes = recorder->liveTextureBytes;
+    }
+    return texture;
+}
+
+static void recording_destroy_render_texture(void* context, void* renderTexture) {
+    RecordingRenderer* recorder = (RecordingRenderer*)context;
+    RecordingTexture* texture = (RecordingTexture*)renderTexture;
+    if (!texture) return;
+    
+    recorder->textureDestructions++;
+    recorder->liveTextures--;
+    recorder->liveTextureBytes -= texture_bytes(texture);
+    free(texture);
+}
+
+static void recording_begin_render_texture(void* context, void* renderTexture) {
+    RecordingRenderer* recorder = (RecordingRenderer*)context;
+    (void)renderTexture;
+    recorder->renderTexturePasses++;
+    recorder->inRenderTexture = true;
+}
+
+static void recording_end_render_texture(void* context) {
+    RecordingRenderer* recorder = (RecordingRenderer*)context;
+    recorder->inRenderTexture = false;
+}
+
+static void recording_execute_command(void* context, const RenderCommand* command) {
+    RecordingRenderer* recorder = (RecordingRenderer*)context;
+    recorder->commands++;
+    switch (command->type) {
+        case RENDER_COMMAND_TYPE_RECTANGLE: recorder->rectangleCommands++; break;
+        case RENDER_COMMAND_TYPE_TEXTURE: recorder->textureCommands++; break;
+        case RENDER_COMMAND_TYPE_TEXTURE_PRO: recorder->textureProCommands++; break;
+        default: break;
+    }
+}
+
+static void* recording_get_render_texture_texture(void* context, void* renderTexture) {
+    (void)context;
+    return renderTexture;
+}
+
+static RenderVector2 recording_world_to_screen(void* context, CameraHandle camera, AspectFitHandle aspectFit, RenderVector2 world) {
+    const RecordingCamera* cam = (const RecordingCamera*)camera;
+    const RecordingAspectFit* fit = (const RecordingAspectFit*)aspectFit;
+    (void)context;
+    
+    RenderVector2 screen;
+    screen.x = ((world.x - cam->target.x) * cam->zoom + cam->offset.x) * fit->scale + fit->offset.x;
+    screen.y = ((world.y - cam->target.y) * cam->zoom + cam->offset.y) * fit->scale + fit->offset.y;
+    return screen;
+}
+
+static RenderVector2 recording_screen_to_world(void* context, CameraHandle camera, AspectFitHandle aspectFit, RenderVector2 screen) {
+    const RecordingCamera* cam = (const RecordingCamera*)camera;
+    const RecordingAspectFit* fit = (const RecordingAspectFit*)aspectFit;
+    (void)context;
+    
+    RenderVector2 world;
+    world.x = ((screen.x - fit->offset.x) / fit->scale - cam->offset.x) / cam->zoom + cam->target.x;
+    world.y = ((screen.y - fit->offset.y) / fit->scale - cam->offset.y) / cam->zoom + cam->target.y;
+    return world;
+}
+
+static float recording_get_camera_zoom(void* context, CameraHandle camera) {
+    (void)context;
+    return ((const RecordingCamera*)camera)->zoom;
+}
+
+static float recording_get_aspect_fit_scale(void* context, AspectFitHandle aspectFit) {
+    (void)context;
+    return ((const RecordingAspectFit*)aspectFit)->scale;
+}
+
+// No pixels are kept: reads return a cleared image, writes are only counted
+static bool recording_read_render_texture(void* context, void* renderTexture, void* outPixels) {
+    RecordingRenderer* recorder = (RecordingRenderer*)context;
+    RecordingTexture* texture = (RecordingTexture*)renderTexture;
+    if (!texture) return false;
+    
+    memset(outPixels, 0, texture_bytes(texture));
+    recorder->pixelReads++;
+    return true;
+}
+
+static bool recording_write_render_texture(void* context, void* renderTexture, const void* pixels) {
+    RecordingRenderer* recorder = (RecordingRenderer*)context;
+    (void)pixels;
+    if (!renderTexture) return false;
+    
+    recorder->pixelWrites++;
+    return true;
+}
+
+static const ChunkRenderBackend RECORDING_BACKEND = {
+    recording_create_render_texture,
+    recording_destroy_render_texture,
+    recording_begin_render_texture,
+    recording_end_render_texture,
+    recording_execute_command,
+    recording_get_render_texture_texture,
+    recording_world_to_screen,
+    recording_screen_to_world,
+    recording_get_camera_zoom,
+    recording_get_aspect_fit_scale,
+    recording_read_render_texture,
+    recording_write_render_texture
+};
+
+void RecordingRenderer_init(RecordingRenderer* recorder) {
+    memset(recorder, 0, sizeof(RecordingRenderer));
+}
+
+void RecordingRenderer_reset_commands(RecordingRenderer* recorder) {
+    recorder->commands = 0;
+    recorder->rectangleCommands = 0;
+    recorder->textureCommands = 0;
+    recorder->textureProCommands = 0;
+    recorder->batches = 0;
+    recorder->batchedQuads = 0;
+    recorder->renderTexturePasses = 0;
+    recorder->pixelReads = 0;
+    recorder->pixelWrites = 0;
+}
+
+const ChunkRenderBackend* RecordingRenderer_backend(void) {
+    return &RECORDING_BACKEND;
+}
+
+bool RecordingRenderer_submit_batch(Renderer* renderer,
+                                    void* atlasTexture,
+                                    const ChunkTileQuad* quads,
+                                    size_t count,
+                                    void* userData) {
+    RecordingRenderer* recorder = (RecordingRenderer*)userData;
+    (void)renderer;
+    (void)atlasTexture;
+    (void)quads;
+    if (!recorder) return false;
+    
+    recorder->commands++;
+    recorder->batches++;
+    recorder->batchedQuads += count;
+    return true;
+}
@@ -0,0 +1,449 @@
+#include "chunk_test_fixture.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Chunk images written to the disk cache must come back pixel for pixel.
+// RecordingRenderer keeps no pixels, so this test wraps it with a backend
+// that rasterizes tile commands into CPU images: every tile is filled with
+// a color derived from its atlas source rect, which makes the expected
+// image of any chunk easy to compute from its tile ids
+
+#define WORLD_SIZE 256
+#define TILE_ID_COUNT 16
+#define TILE_SIZE 4
+#define CHUNK_SIZE 8
+#define RENDER_RADIUS 2
+#define SIMULATION_RADIUS 3
+#define VIEWPORT_WIDTH 320.0f
+#define VIEWPORT_HEIGHT 240.0f
+#define CACHE_ENTRIES 512
+#define CACHE_PATH "chunk_disk_cache_test.cache"
+#define ATLAS_KEY 0x5eedULL
+#define RELOADED_ATLAS_KEY 0xa71a5ULL
+#define SETTLE_FRAMES 30
+#define WALK_FRAMES 3
+
+typedef struct PixelTexture {
+    int width;
+    int height;
+    uint32_t* pixels;
+} PixelTexture;
+
+// Recording backend plus real pixels (context is the PixelBackend)
+typedef struct PixelBackend {
+    RecordingRenderer* recorder;
+    PixelTexture* target;        // Texture between begin/end, NULL otherwise
+} PixelBackend;
+
+static const ChunkTestConfig CONFIG = {
+    TILE_SIZE, CHUNK_SIZE, RENDER_RADIUS, SIMULATION_RADIUS,
+    VIEWPORT_WIDTH, VIEWPORT_HEIGHT, TILE_ID_COUNT, 4, false
+};
+
+static int failures;
+
+static const ChunkRenderBackend* recording(void) {
+    return RecordingRenderer_backend();
+}
+
+static uint32_t tile_color(RenderRect srcRect) {
+    uint32_t column = (uint32_t)(srcRect.x / TILE_SIZE);
+    uint32_t row = (uint32_t)(srcRect.y / TILE_SIZE);
+    return 0xff000000u | (row << 16) | (column << 8) | 0x5au;
+}
+
+static void* pixel_create_render_texture(void* context, int width, int height) {
+    PixelTexture* texture = (PixelTexture*)malloc(sizeof(PixelTexture));
+    (void)context;
+    if (!texture) return NULL;
+    
+    texture->width = width;
+    texture->height = height;
+    texture->pixels = (uint32_t*)calloc((size_t)width * (size_t)height, sizeof(uint32_t));
+    if (!texture->pixels) {
+        free(texture);
+        return NULL;
+    }
+    return texture;
+}
+
+static void pixel_destroy_render_texture(void* context, void* renderTexture) {
+    PixelTexture* texture = (PixelTexture*)renderTexture;
+    (void)context;
+    if (!texture) return;
+    
+    free(texture->pixels);
+    free(texture);
+}
+
+static void pixel_begin_render_texture(void* context, void* renderTexture) {
+    PixelBackend* backend = (PixelBackend*)context;
+    recording()->begin_render_texture(backend->recorder, renderTexture);
+    backend->target = (PixelTexture*)renderTexture;
+}
+
+static void pixel_end_render_texture(void* context) {
+    PixelBackend* backend = (PixelBackend*)context;
+    recording()->end_render_texture(backend->recorder);
+    backend->target = NULL;
+}
+
+static void fill_rect(PixelTexture* texture, RenderRect bounds, uint32_t color) {
+    int minX = (int)bounds.x;
+    int minY = (int)bounds.y;
+    int maxX = (int)(bounds.x + bounds.width);
+    int maxY = (int)(bounds.y + bounds.height);
+    if (minX < 0) minX = 0;
+    if (minY < 0) minY = 0;
+    if (maxX > texture->width) maxX = texture->width;
+    if (maxY > texture->height) maxY = texture->height;
+    for (int y = minY; y < maxY; y++) {
+        for (int x = minX; x < maxX; x++) {
+            texture->pixels[(size_t)y * (size_t)texture->width + (size_t)x] = color;
+        }
+    }
+}
+
+static void pixel_execute_command(void* context, const RenderCommand* command) {
+    PixelBackend* backend = (PixelBackend*)context;
+    recording()->execute_command(backend->recorder, command);
+    if (!backend->target) return;
+    
+    // Chunk rebuilds clear their region and then draw atlas tiles
+    if (command->type == RENDER_COMMAND_TYPE_RECTANGLE) {
+        fill_rect(backend->target, command->bounds, 0xff000000u);
+    } else if (command->type == RENDER_COMMAND_TYPE_TEXTURE) {
+        fill_rect(backend->target, command->bounds, tile_color(command->data.texture.srcRect));
+    }
+}
+
+static bool pixel_read_render_texture(void* context, void* renderTexture, void* outPixels) {
+    PixelBackend* backend = (PixelBackend*)context;
+    PixelTexture* texture = (PixelTexture*)renderTexture;
+    if (!texture) return false;
+    
+    memcpy(outPixels, texture->pixels, (size_t)texture->width * (size_t)texture->height * 4);
+    backend->recorder->pixelReads++;
+    return true;
+}
+
+static bool pixel_write_render_texture(void* context, void* renderTexture, const void* pixels) {
+    PixelBackend* backend = (PixelBackend*)context;
+    PixelTexture* texture = (PixelTexture*)renderTexture;
+    if (!texture) return false;
+    
+    memcpy(texture->pixels, pixels, (size_t)texture->width * (size_t)texture->height * 4);
+    backend->recorder->pixelWrites++;
+    return true;
+}
+
+static void* pixel_get_render_texture_texture(void* context, void* renderTexture) {
+    (void)context;
+    return renderTexture;
+}
+
+static RenderVector2 pixel_world_to_screen(void* context, CameraHandle camera, AspectFitHandle aspectFit, RenderVector2 world) {
+    return recording()->world_to_screen(((PixelBackend*)context)->recorder, camera, aspectFit, world);
+}
+
+static RenderVector2 pixel_screen_to_world(void* context, CameraHandle camera, AspectFitHandle aspectFit, RenderVector2 screen) {
+    return recording()->screen_to_world(((PixelBackend*)context)->recorder, camera, aspectFit, screen);
+}
+
+static float pixel_get_camera_zoom(void* context, CameraHandle camera) {
+    return recording()->get_camera_zoom(((PixelBackend*)context)->recorder, camera);
+}
+
+static float pixel_get_aspect_fit_scale(void* context, AspectFitHandle aspectFit) {
+    return recording()->get_aspect_fit_scale(((PixelBackend*)context)->recorder, aspectFit);
+}
+
+static const ChunkRenderBackend PIXEL_BACKEND = {
+    pixel_create_render_texture,
+    pixel_destroy_render_texture,
+    pixel_begin_render_texture,
+    pixel_end_render_texture,
+    pixel_execute_command,
+    pixel_get_render_texture_texture,
+    pixel_world_to_screen,
+    pixel_screen_to_world,
+    pixel_get_camera_zoom,
+    pixel_get_aspect_fit_scale,
+    pixel_read_render_texture,
+    pixel_write_render_texture
+};
+
+// Same pixels without read/write hooks, like the default Renderer backend:
+// the cache keeps built tile quads instead of images
+static const ChunkRenderBackend QUAD_BACKEND = {
+    pixel_create_render_texture,
+    pixel_destroy_render_texture,
+    pixel_begin_render_texture,
+    pixel_end_render_texture,
+    pixel_execute_command,
+    pixel_get_render_texture_texture,
+    pixel_world_to_screen,
+    pixel_screen_to_world,
+    pixel_get_camera_zoom,
+    pixel_get_aspect_fit_scale,
+    NULL,
+    NULL
+};
+
+typedef struct TestContext {
+    ChunkTestContext base;
+    PixelBackend backend;
+    int atlasShift;              // Atlas generation: tile id i is drawn with the rect of id i + shift
+    size_t diskCacheLoads;       // Summed over frames run by run_frames
+    size_t diskCacheStores;
+} TestContext;
+
+static int world_tile(const ChunkTestWorld* world, int tileX, int tileY) {
+    return *chunk_test_world_tile(world, tileX, tileY);
+}
+
+static RenderRect atlas_rect(int shift, int id) {
+    return chunk_test_atlas_rect(&CONFIG, (id + shift) % TILE_ID_COUNT);
+}
+
+static bool context_init_keyed(TestContext* ctx, ChunkTestWorld* world, const ChunkRenderBackend* backend,
+                               bool dedup, uint64_t atlasKey) {
+    memset(ctx, 0, sizeof(TestContext));
+    chunk_test_context_init(&ctx->base, &CONFIG, world);
+    ctx->backend.recorder = &ctx->base.recorder;
+    ChunkRenderSystem_set_backend(&ctx->base.system, backend, &ctx->backend);
+    ChunkRenderSystem_set_chunk_dedup(&ctx->base.system, dedup);
+    return ChunkRenderSystem_enable_disk_cache(&ctx->base.system, CACHE_PATH, CACHE_ENTRIES, atlasKey);
+}
+
+static bool context_init(TestContext* ctx, ChunkTestWorld* world, const ChunkRenderBackend* backend, bool dedup) {
+    return context_init_keyed(ctx, world, backend, dedup, ATLAS_KEY);
+}
+
+// Hot reload: a new atlas layout, without a new disk cache key yet
+static void reload_atlas(TestContext* ctx, int shift) {
+    ChunkRenderSystem_invalidate_atlas(&ctx->base.system);
+    for (int id = 0; id < TILE_ID_COUNT; id++) {
+        ChunkRenderSystem_set_atlas_rect(&ctx->base.system, id, atlas_rect(shift, id));
+    }
+    ctx->atlasShift = shift;
+}
+
+static void context_cleanup(TestContext* ctx) {
+    chunk_test_context_cleanup(&ctx->base);
+}
+
+static void look_at(TestContext* ctx, int tileX, int tileY) {
+    chunk_test_look_at(&ctx->base, tileX, tileY);
+}
+
+static void run_frames(TestContext* ctx, int frames) {
+    for (int frame = 0; frame < frames; frame++) {
+        ChunkRenderSystem_update(&ctx->base.system, NULL, 0, NULL);
+        ChunkRenderSystem_render(&ctx->base.system, NULL, 0, (CameraHandle)&ctx->base.camera, (AspectFitHandle)&ctx->base.aspectFit);
+    
+        ChunkRenderStats stats = ChunkRenderSystem_get_stats(&ctx->base.system);
+        ctx->diskCacheLoads += stats.frame.diskCacheLoads;
+        ctx->diskCacheStores += stats.frame.diskCacheStores;
+    }
+}
+
+// Compare every resident chunk image with the one its tiles should produce
+static size_t count_wrong_chunks(TestContext* ctx, const ChunkTestWorld* world) {
+    const int pixelSize = CHUNK_SIZE * TILE_SIZE;
+    size_t wrong = 0;
+    for (int chunkY = 0; chunkY < WORLD_SIZE / CHUNK_SIZE; chunkY++) {
+        for (int chunkX = 0; chunkX < WORLD_SIZE / CHUNK_SIZE; chunkX++) {
+            IntCoord coord = {chunkX, chunkY};
+            ChunkRenderData* chunk = (ChunkRenderData*)Table_get(ctx->base.system.chunks, &coord);
+            if (!chunk || !chunk->isLoaded || chunk->isDirty) continue;
+    
+            const PixelTexture* texture = (const PixelTexture*)chunk->renderTexture;
+            bool match = texture && texture->width == pixelSize && texture->height == pixelSize;
+            for (int y = 0; match && y < pixelSize; y++) {
+                for (int x = 0; x < pixelSize; x++) {
+                    int id = world_tile(world, chunkX * CHUNK_SIZE + x / TILE_SIZE, chunkY * CHUNK_SIZE + y / TILE_SIZE);
+                    if (texture->pixels[(size_t)y * (size_t)pixelSize + (size_t)x] != tile_color(atlas_rect(ctx->atlasShift, id))) {
+                        match = false;
+                        break;
+                    }
+                }
+            }
+            if (!match) wrong++;
+        }
+    }
+    return wrong;
+}
+
+static void report(const char* name, bool ok, const char* detail) {
+    if (ok) {
+        printf("ok   %s\n", name);
+    } else {
+        printf("FAIL %s: %s\n", name, detail);
+        failures++;
+    }
+}
+
+// Images written by flush at shutdown are uploaded by a fresh system
+static void test_flush_round_trip(ChunkTestWorld* world, const char* name, const ChunkRenderBackend* backend) {
+    char detail[160];
+    remove(CACHE_PATH);
+    
+    TestContext writer;
+    if (!context_init(&writer, world, backend, false)) {
+        report(name, false, "disk cache did not open");
+        context_cleanup(&writer);
+        return;
+    }
+    ChunkRenderSystem_add_manual_observer(&writer.base.system, 128, 128);
+    look_at(&writer, 128, 128);
+    run_frames(&writer, SETTLE_FRAMES);
+    size_t drawn = ChunkRenderSystem_get_resident_count(&writer.base.system);
+    context_cleanup(&writer);
+    
+    TestContext reader;
+    context_init(&reader, world, backend, false);
+    ChunkRenderSystem_add_manual_observer(&reader.base.system, 128, 128);
+    look_at(&reader, 128, 128);
+    run_frames(&reader, SETTLE_FRAMES);
+    size_t wrong = count_wrong_chunks(&reader, world);
+    snprintf(detail, sizeof(detail), "%zu of %zu chunks loaded, %zu wrong images",
+             reader.diskCacheLoads, drawn, wrong);
+    report(name, drawn > 0 && reader.diskCacheLoads == drawn && wrong == 0, detail);
+    context_cleanup(&reader);
+}
+
+// Images of evicted chunks are queued, written during later updates and
+// uploaded by a fresh system
+static void test_evict_round_trip(ChunkTestWorld* world, const char* name, const ChunkRenderBackend* backend,
+                                  bool dedup) {
+    char detail[160];
+    remove(CACHE_PATH);
+    
+    TestContext writer;
+    if (!context_init(&writer, world, backend, dedup)) {
+        report(name, false, "disk cache did not open");
+        context_cleanup(&writer);
+        return;
+    }
+    ChunkRenderSystem_set_rebuild_budget(&writer.base.system, 4, 0);
+    ChunkRenderSystem_set_residency_budget(&writer.base.system, 4, 0);
+    
+    ChunkRenderSystem_add_manual_observer(&writer.base.system, 64, 64);
+    look_at(&writer, 64, 64);
+    run_frames(&writer, SETTLE_FRAMES);
+    size_t drawn = ChunkRenderSystem_get_resident_count(&writer.base.system);
+    ChunkRenderSystem_remove_manual_observer(&writer.base.system, 64, 64);
+    
+    // Walk away in steps, so targets of evicted chunks would be reused by
+    // new chunks before their queued image is written, unless the queue
+    // holds on to them. The first area only reaches the file through it
+    for (int tile = 96; tile <= 192; tile += 32) {
+        ChunkRenderSystem_add_manual_observer(&writer.base.system, tile, tile);
+        look_at(&writer, tile, tile);
+        run_frames(&writer, WALK_FRAMES);
+        ChunkRenderSystem_remove_manual_observer(&writer.base.system, tile, tile);
+    }
+    run_frames(&writer, SETTLE_FRAMES);
+    size_t stores = writer.diskCacheStores;
+    context_cleanup(&writer);
+    
+    TestContext reader;
+    context_init(&reader, world, backend, false);
+    ChunkRenderSystem_add_manual_observer(&reader.base.system, 64, 64);
+    look_at(&reader, 64, 64);
+    run_frames(&reader, SETTLE_FRAMES);
+    size_t wrong = count_wrong_chunks(&reader, world);
+    
+    snprintf(detail, sizeof(detail), "%zu stores during updates, %zu of %zu chunks loaded, %zu wrong images",
+             stores, reader.diskCacheLoads, drawn, wrong);
+    report(name, stores >= drawn && reader.diskCacheLoads == drawn && wrong == 0, detail);
+    context_cleanup(&reader);
+}
+
+// Reloading the atlas must not tie file entries to the in-process atlas
+// version: a later run that reloads once as well must not get the images
+// of another atlas, and images stored under the reloaded atlas's key must
+// load in a fresh run
+static void test_atlas_reload(ChunkTestWorld* world, const char* name) {
+    char detail[200];
+    remove(CACHE_PATH);
+    
+    // Reload without a new key: nothing is stored while the cache is paused
+    TestContext writer;
+    if (!context_init(&writer, world, &PIXEL_BACKEND, false)) {
+        report(name, false, "disk cache did not open");
+        context_cleanup(&writer);
+        return;
+    }
+    ChunkRenderSystem_add_manual_observer(&writer.base.system, 128, 128);
+    look_at(&writer, 128, 128);
+    run_frames(&writer, SETTLE_FRAMES);
+    reload_atlas(&writer, 1);
+    run_frames(&writer, SETTLE_FRAMES);
+    context_cleanup(&writer);
+    
+    // Another run with the same key reloads to a different atlas
+    TestContext other;
+    context_init(&other, world, &PIXEL_BACKEND, false);
+    reload_atlas(&other, 2);
+    ChunkRenderSystem_add_manual_observer(&other.base.system, 128, 128);
+    look_at(&other, 128, 128);
+    run_frames(&other, SETTLE_FRAMES);
+    size_t otherLoads = other.diskCacheLoads;
+    size_t otherWrong = count_wrong_chunks(&other, world);
+    context_cleanup(&other);
+    
+    // Reload and re-key: images of the new atlas are stored under its key
+    TestContext rekeyed;
+    context_init(&rekeyed, world, &PIXEL_BACKEND, false);
+    reload_atlas(&rekeyed, 1);
+    ChunkRenderSystem_set_disk_cache_atlas_key(&rekeyed.base.system, RELOADED_ATLAS_KEY);
+    ChunkRenderSystem_add_manual_observer(&rekeyed.base.system, 128, 128);
+    look_at(&rekeyed, 128, 128);
+    run_frames(&rekeyed, SETTLE_FRAMES);
+    size_t drawn = ChunkRenderSystem_get_resident_count(&rekeyed.base.system);
+    context_cleanup(&rekeyed);
+    
+    // A fresh run starting on the reloaded atlas reopens the cache with its key
+    TestContext reader;
+    context_init_keyed(&reader, world, &PIXEL_BACKEND, false, RELOADED_ATLAS_KEY);
+    for (int id = 0; id < TILE_ID_COUNT; id++) {
+        ChunkRenderSystem_set_atlas_rect(&reader.base.system, id, atlas_rect(1, id));
+    }
+    reader.atlasShift = 1;
+    ChunkRenderSystem_add_manual_observer(&reader.base.system, 128, 128);
+    look_at(&reader, 128, 128);
+    run_frames(&reader, SETTLE_FRAMES);
+    size_t wrong = count_wrong_chunks(&reader, world);
+    
+    snprintf(detail, sizeof(detail),
+             "other atlas: %zu loads, %zu wrong images; re-keyed: %zu of %zu chunks loaded, %zu wrong images",
+             otherLoads, otherWrong, reader.diskCacheLoads, drawn, wrong);
+    report(name, otherLoads == 0 && otherWrong == 0 && drawn > 0 &&
+                 reader.diskCacheLoads == drawn && wrong == 0, detail);
+    context_cleanup(&reader);
+}
+
+int main(void) {
+    ChunkTestWorld noise;
+    ChunkTestWorld ocean;
+    if (!chunk_test_world_init(&noise, WORLD_SIZE, TILE_ID_COUNT, 0x9e3779b9u) ||
+        !chunk_test_world_init_ocean(&ocean, WORLD_SIZE, CHUNK_SIZE, 0, TILE_ID_COUNT, 0)) {
+        return 1;
+    }
+    
+    test_flush_round_trip(&noise, "flush-round-trip", &PIXEL_BACKEND);
+    test_atlas_reload(&noise, "atlas-reload");
+    test_evict_round_trip(&noise, "evict-round-trip", &PIXEL_BACKEND, false);
+    // Every chunk shares one texture, so evictions queue borrowed textures
+    test_evict_round_trip(&ocean, "evict-round-trip-shared", &PIXEL_BACKEND, true);
+    test_flush_round_trip(&noise, "flush-round-trip-quads", &QUAD_BACKEND);
+    test_evict_round_trip(&noise, "evict-round-trip-quads", &QUAD_BACKEND, false);
+    
+    remove(CACHE_PATH);
+    chunk_test_world_free(&noise);
+    chunk_test_world_free(&ocean);
+    return failures > 0 ? 1 : 0;
+}
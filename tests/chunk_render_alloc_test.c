@@ -0,0 +1,117 @@
+#include "chunk_test_fixture.h"
+#include "chunk_test_heap.h"
+#include <stdio.h>
+
+// The render pass must not allocate once the observer set and camera are
+// stable: after a warm-up, update + render may neither grow the system
+// arena nor touch the heap. Runs on RecordingRenderer, no GPU required.
+// Heap calls are counted through linker wrapping (chunk_test_heap.h);
+// where that is unavailable only the arena is checked
+
+#define WORLD_SIZE 1024
+#define TILE_ID_COUNT 256
+#define TILE_SIZE 16
+#define CHUNK_SIZE 32
+#define RENDER_RADIUS 3
+#define SIMULATION_RADIUS 5
+#define VIEWPORT_WIDTH 1280.0f
+#define VIEWPORT_HEIGHT 720.0f
+#define WARMUP_FRAMES 120
+#define STEADY_FRAMES 120
+
+typedef ChunkTestContext TestContext;
+
+// Configuration applied on top of the default system before warm-up
+typedef void (*TestSetupFn)(TestContext* ctx);
+
+static const ChunkTestConfig CONFIG = {
+    TILE_SIZE, CHUNK_SIZE, RENDER_RADIUS, SIMULATION_RADIUS,
+    VIEWPORT_WIDTH, VIEWPORT_HEIGHT, TILE_ID_COUNT, 16, true
+};
+
+static int failures;
+
+static void run_frame(TestContext* ctx) {
+    ChunkRenderSystem_update(&ctx->system, NULL, 0, NULL);
+    ChunkRenderSystem_render(&ctx->system, NULL, 0, (CameraHandle)&ctx->camera, (AspectFitHandle)&ctx->aspectFit);
+}
+
+static void setup_default(TestContext* ctx) {
+    (void)ctx;
+}
+
+static void setup_paged(TestContext* ctx) {
+    ChunkRenderSystem_enable_page_packing(&ctx->system, 4);
+}
+
+static void setup_lod(TestContext* ctx) {
+    ChunkRenderSystem_set_lod(&ctx->system, 2, 0.1f);
+    ctx->camera.zoom = 0.3f;
+}
+
+static void setup_direct(TestContext* ctx) {
+    ChunkRenderSystem_set_render_mode(&ctx->system, CHUNK_RENDER_MODE_DIRECT);
+}
+
+static void setup_budgeted(TestContext* ctx) {
+    ChunkRenderSystem_set_rebuild_budget(&ctx->system, 2, 0);
+    ChunkRenderSystem_set_residency_budget(&ctx->system, 64, 0);
+}
+
+static void test_steady_state(ChunkTestWorld* world, const char* name, TestSetupFn setup) {
+    TestContext ctx;
+    chunk_test_context_init(&ctx, &CONFIG, world);
+    chunk_test_look_at(&ctx, 512, 512);
+    setup(&ctx);
+    
+    // A fixed observer set: a cluster around the camera and a few far away
+    ChunkRenderSystem_add_manual_observer(&ctx.system, 512, 512);
+    ChunkRenderSystem_add_manual_observer(&ctx.system, 530, 500);
+    ChunkRenderSystem_add_manual_observer(&ctx.system, 490, 540);
+    ChunkRenderSystem_add_manual_observer(&ctx.system, 100, 900);
+    int extra = ChunkRenderSystem_add_viewport(&ctx.system, VIEWPORT_WIDTH * 0.25f, VIEWPORT_HEIGHT * 0.25f);
+    
+    for (int frame = 0; frame < WARMUP_FRAMES; frame++) {
+        run_frame(&ctx);
+        ChunkRenderSystem_render_viewport(&ctx.system, extra, NULL, 0,
+                                          (CameraHandle)&ctx.camera, (AspectFitHandle)&ctx.aspectFit);
+    }
+    
+    size_t arenaBefore = ctx.system.arenaAllocations;
+    size_t heapBefore = chunk_test_heap_allocations();
+    for (int frame = 0; frame < STEADY_FRAMES; frame++) {
+        run_frame(&ctx);
+        ChunkRenderSystem_render_viewport(&ctx.system, extra, NULL, 0,
+                                          (CameraHandle)&ctx.camera, (AspectFitHandle)&ctx.aspectFit);
+    }
+    size_t arenaDelta = ctx.system.arenaAllocations - arenaBefore;
+    size_t heapDelta = chunk_test_heap_allocations() - heapBefore;
+    
+    if (arenaDelta != 0 || heapDelta != 0) {
+        printf("FAIL %s: %zu arena and %zu heap allocations over %d steady frames\n",
+               name, arenaDelta, heapDelta, STEADY_FRAMES);
+        failures++;
+    } else {
+        printf("ok   %s\n", name);
+    }
+    
+    chunk_test_context_cleanup(&ctx);
+}
+
+int main(void) {
+    ChunkTestWorld world;
+    if (!chunk_test_world_init(&world, WORLD_SIZE, TILE_ID_COUNT, 0x9e3779b9u)) return 1;
+    
+    if (!chunk_test_heap_counted()) {
+        printf("note: heap allocations are not counted on this platform\n");
+    }
+    
+    test_steady_state(&world, "steady-cached", setup_default);
+    test_steady_state(&world, "steady-paged", setup_paged);
+    test_steady_state(&world, "steady-lod", setup_lod);
+    test_steady_state(&world, "steady-direct", setup_direct);
+    test_steady_state(&world, "steady-budgeted", setup_budgeted);
+    
+    chunk_test_world_free(&world);
+    return failures > 0 ? 1 : 0;
+}
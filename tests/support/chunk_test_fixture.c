@@ -0,0 +1,123 @@
+#include "chunk_test_fixture.h"
+#include <stdlib.h>
+#include <string.h>
+
+static int wrap(const ChunkTestWorld* world, int v) {
+    int m = v % world->size;
+    return m < 0 ? m + world->size : m;
+}
+
+uint32_t chunk_test_random(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+bool chunk_test_world_init(ChunkTestWorld* world, int size, int tileIdCount, uint32_t seed) {
+    size_t tiles = (size_t)size * (size_t)size;
+    world->size = size;
+    world->tileIds = (int*)malloc(sizeof(int) * tiles);
+    if (!world->tileIds) return false;
+    
+    uint32_t rng = seed;
+    for (size_t i = 0; i < tiles; i++) {
+        world->tileIds[i] = (int)(chunk_test_random(&rng) % (uint32_t)tileIdCount);
+    }
+    return true;
+}
+
+bool chunk_test_world_init_ocean(ChunkTestWorld* world, int size, int chunkSize, int islandEvery,
+                                 int tileIdCount, uint32_t seed) {
+    world->size = size;
+    world->tileIds = (int*)calloc((size_t)size * (size_t)size, sizeof(int));
+    if (!world->tileIds) return false;
+    if (islandEvery <= 0) return true;
+    
+    uint32_t rng = seed;
+    for (int chunkY = 0; chunkY < size / chunkSize; chunkY++) {
+        for (int chunkX = 0; chunkX < size / chunkSize; chunkX++) {
+            if (chunk_test_random(&rng) % (uint32_t)islandEvery != 0) continue;
+            for (int y = 0; y < chunkSize; y++) {
+                int* row = world->tileIds + (size_t)(chunkY * chunkSize + y) * (size_t)size + (size_t)chunkX * (size_t)chunkSize;
+                for (int x = 0; x < chunkSize; x++) {
+                    row[x] = (int)(chunk_test_random(&rng) % (uint32_t)tileIdCount);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+void chunk_test_world_free(ChunkTestWorld* world) {
+    free(world->tileIds);
+    world->tileIds = NULL;
+}
+
+int* chunk_test_world_tile(const ChunkTestWorld* world, int tileX, int tileY) {
+    return world->tileIds + (size_t)wrap(world, tileY) * (size_t)world->size + (size_t)wrap(world, tileX);
+}
+
+bool chunk_test_world_fetch_row(Tilemap* tilemap, int tileX, int tileY, int count, int* outTileIds, void* userData) {
+    const ChunkTestWorld* world = (const ChunkTestWorld*)userData;
+    const int* row = world->tileIds + (size_t)wrap(world, tileY) * (size_t)world->size;
+    (void)tilemap;
+    
+    int x = wrap(world, tileX);
+    while (count > 0) {
+        int run = world->size - x < count ? world->size - x : count;
+        memcpy(outTileIds, row + x, sizeof(int) * (size_t)run);
+        outTileIds += run;
+        count -= run;
+        x = 0;
+    }
+    return true;
+}
+
+RenderRect chunk_test_atlas_rect(const ChunkTestConfig* config, int tileId) {
+    RenderRect src = {
+        (float)((tileId % config->atlasColumns) * config->tileSize),
+        (float)((tileId / config->atlasColumns) * config->tileSize),
+        (float)config->tileSize,
+        (float)config->tileSize
+    };
+    return src;
+}
+
+void chunk_test_context_init(ChunkTestContext* ctx, const ChunkTestConfig* config, ChunkTestWorld* world) {
+    static Atlas atlas;  // Only its address is used; rects come from the LUT
+    
+    memset(ctx, 0, sizeof(ChunkTestContext));
+    ctx->arena = Arena_new();
+    ctx->tileSize = config->tileSize;
+    ctx->rng = 12345u;
+    ChunkRenderSystem_init(&ctx->system, ctx->arena, NULL, &atlas, NULL,
+                           config->tileSize, config->chunkSize, config->renderRadius, config->simulationRadius);
+    RecordingRenderer_init(&ctx->recorder);
+    ChunkRenderSystem_set_backend(&ctx->system, RecordingRenderer_backend(), &ctx->recorder);
+    if (config->batched) {
+        ChunkRenderSystem_set_batch_submit(&ctx->system, RecordingRenderer_submit_batch, &ctx->recorder);
+    }
+    ChunkRenderSystem_set_tile_row_fetch(&ctx->system, chunk_test_world_fetch_row, world);
+    ChunkRenderSystem_set_viewport_size(&ctx->system, config->viewportWidth, config->viewportHeight);
+    for (int id = 0; id < config->tileIdCount; id++) {
+        ChunkRenderSystem_set_atlas_rect(&ctx->system, id, chunk_test_atlas_rect(config, id));
+    }
+    
+    ctx->camera.zoom = 1.0f;
+    ctx->camera.offset.x = config->viewportWidth * 0.5f;
+    ctx->camera.offset.y = config->viewportHeight * 0.5f;
+    ctx->aspectFit.scale = 1.0f;
+}
+
+void chunk_test_context_cleanup(ChunkTestContext* ctx) {
+    ChunkRenderSystem_cleanup(&ctx->system);
+    Arena_dispose(&ctx->arena);
+}
+
+void chunk_test_look_at(ChunkTestContext* ctx, int tileX, int tileY) {
+    ctx->camera.target.x = (float)(tileX * ctx->tileSize);
+    ctx->camera.target.y = (float)(tileY * ctx->tileSize);
+}
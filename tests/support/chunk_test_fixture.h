@@ -0,0 +1,73 @@
+#ifndef CHUNK_TEST_FIXTURE_H
+#define CHUNK_TEST_FIXTURE_H
+
+#include "gramarye_chunk_renderer/chunk_render_system.h"
+#include "gramarye_chunk_renderer/recording_renderer.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Shared fixture for the headless tests and the benchmark suite: a dense
+// tile world wrapped in both directions, and a ChunkRenderSystem on
+// RecordingRenderer reading it through the bulk row hook
+
+// Square world of tile ids; coordinates wrap in both directions
+typedef struct ChunkTestWorld {
+    int* tileIds;
+    int size;                    // Tiles per side
+} ChunkTestWorld;
+
+// Geometry of a test system and its atlas grid
+typedef struct ChunkTestConfig {
+    int tileSize;
+    int chunkSize;
+    int renderRadius;
+    int simulationRadius;
+    float viewportWidth;
+    float viewportHeight;
+    int tileIdCount;             // Ids filled into the atlas lookup table
+    int atlasColumns;            // Tiles per atlas row
+    bool batched;                // Install RecordingRenderer_submit_batch
+} ChunkTestConfig;
+
+typedef struct ChunkTestContext {
+    Arena_T arena;
+    ChunkRenderSystem system;
+    RecordingRenderer recorder;
+    RecordingCamera camera;
+    RecordingAspectFit aspectFit;
+    int tileSize;
+    uint32_t rng;                // Seeded per context for scenario randomness
+} ChunkTestContext;
+
+// xorshift32
+uint32_t chunk_test_random(uint32_t* state);
+
+// Uniform noise of ids in [0, tileIdCount); false when out of memory
+bool chunk_test_world_init(ChunkTestWorld* world, int size, int tileIdCount, uint32_t seed);
+
+// Tile 0 everywhere except one in islandEvery chunks, which hold random ids
+// (islandEvery 0 = no islands)
+bool chunk_test_world_init_ocean(ChunkTestWorld* world, int size, int chunkSize, int islandEvery,
+                                 int tileIdCount, uint32_t seed);
+
+void chunk_test_world_free(ChunkTestWorld* world);
+
+// Storage of the tile at a wrapped coordinate
+int* chunk_test_world_tile(const ChunkTestWorld* world, int tileX, int tileY);
+
+// ChunkRenderTileRowFn over a ChunkTestWorld (userData): one copy per contiguous run
+bool chunk_test_world_fetch_row(Tilemap* tilemap, int tileX, int tileY, int count, int* outTileIds, void* userData);
+
+// Atlas source rect of a tile id on the config's atlas grid
+RenderRect chunk_test_atlas_rect(const ChunkTestConfig* config, int tileId);
+
+// Initialize a system on RecordingRenderer over world, with the atlas
+// lookup table filled and the camera centered on world origin
+void chunk_test_context_init(ChunkTestContext* ctx, const ChunkTestConfig* config, ChunkTestWorld* world);
+
+void chunk_test_context_cleanup(ChunkTestContext* ctx);
+
+// Point the camera at a tile
+void chunk_test_look_at(ChunkTestContext* ctx, int tileX, int tileY);
+
+#endif // CHUNK_TEST_FIXTURE_H
@@ -0,0 +1,36 @@
+#include "chunk_test_heap.h"
+
+#ifndef CHUNK_TEST_WRAP_MALLOC
+#define CHUNK_TEST_WRAP_MALLOC 0
+#endif
+
+static size_t heapAllocations;
+
+#if CHUNK_TEST_WRAP_MALLOC
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+void* __wrap_malloc(size_t size) {
+    heapAllocations++;
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    heapAllocations++;
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    heapAllocations++;
+    return __real_realloc(ptr, size);
+}
+#endif
+
+size_t chunk_test_heap_allocations(void) {
+    return heapAllocations;
+}
+
+bool chunk_test_heap_counted(void) {
+    return CHUNK_TEST_WRAP_MALLOC != 0;
+}
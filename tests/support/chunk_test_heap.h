@@ -0,0 +1,18 @@
+#ifndef CHUNK_TEST_HEAP_H
+#define CHUNK_TEST_HEAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Heap call counter shared by the allocation test and the benchmark suite
+// malloc, calloc and realloc are counted through ld --wrap when the target
+// is linked with the wraps and built with CHUNK_TEST_WRAP_MALLOC=1 (static,
+// non-Apple builds); elsewhere nothing is counted
+
+// Heap calls made by the process so far (0 when not counted)
+size_t chunk_test_heap_allocations(void);
+
+// Whether heap calls are counted in this build
+bool chunk_test_heap_counted(void);
+
+#endif // CHUNK_TEST_HEAP_H